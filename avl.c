@@ -3,6 +3,7 @@
 #define CU_AVLTREE_DEBUG 0
 
 static inline int             cuAvlTreeNodeGetHeight(CUavlTree *tree, CUavlTreeNode *node);
+static inline NvU32           cuAvlTreeNodeGetCount(CUavlTree *tree, CUavlTreeNode *node);
 static inline int             cuAvlTreeNodeGetBalance(CUavlTree *tree, CUavlTreeNode *node);
 static inline void            cuAvlTreeNodeRecalculateHeight(CUavlTree *tree, CUavlTreeNode *node);
 static inline CUavlTreeNode **cuAvlTreeNodeGetLinkPointer(CUavlTree *tree, CUavlTreeNode *node);
@@ -90,6 +91,8 @@ static int cuAvlTreeAssertValidRecursive(CUavlTree *tree, CUavlTreeNode *node, i
     }
     height = MAX(lefth, righth) + 1;
     CU_ASSERT(!node || height == node->height);
+    CU_ASSERT(!node || !(tree->flags & CU_AVL_TREE_FLAG_COUNTS) ||
+              node->count == 1 + cuAvlTreeNodeGetCount(tree, node->left) + cuAvlTreeNodeGetCount(tree, node->right));
     return height;
 }
 
@@ -118,9 +121,24 @@ static inline int cuAvlTreeNodeGetBalance(CUavlTree *tree, CUavlTreeNode *node)
     return balance;
 }
 
+static inline NvU32 cuAvlTreeNodeGetCount(CUavlTree *tree, CUavlTreeNode *node)
+{
+    UNUSED(tree);
+    if (node) {
+        return node->count;
+    }
+    return 0;
+}
+
+// Every structural change (insert, remove, rotations, build, join) ends by
+// recalculating the heights on the path to the root, so subtree counts are
+// kept up to date here as well
 static inline void cuAvlTreeNodeRecalculateHeight(CUavlTree *tree, CUavlTreeNode *node)
 {
     node->height = 1 + MAX(cuAvlTreeNodeGetHeight(tree, node->left), cuAvlTreeNodeGetHeight(tree, node->right));
+    if (tree->flags & CU_AVL_TREE_FLAG_COUNTS) {
+        node->count = 1 + cuAvlTreeNodeGetCount(tree, node->left) + cuAvlTreeNodeGetCount(tree, node->right);
+    }
 }
 
 static inline CUavlTreeNode **cuAvlTreeNodeGetLinkPointer(CUavlTree *tree, CUavlTreeNode *node)
@@ -227,10 +245,16 @@ static void cuAvlTreeNodeRebalance(CUavlTree *tree, CUavlTreeNode *node, int isD
 }
 
 void cuAvlTreeInitialize(CUavlTree *tree, CUavlTreeCompare compare, CUavlTreePrint print)
+{
+    cuAvlTreeInitializeWithFlags(tree, compare, print, 0);
+}
+
+void cuAvlTreeInitializeWithFlags(CUavlTree *tree, CUavlTreeCompare compare, CUavlTreePrint print, NvU32 flags)
 {
     memset(tree, 0, sizeof(*tree));
     tree->print = print;
     tree->compare = compare;
+    tree->flags = flags;
 }
 
 void cuAvlTreeDeinitialize(CUavlTree *tree)
@@ -238,86 +262,132 @@ void cuAvlTreeDeinitialize(CUavlTree *tree)
     memset(tree, 0, sizeof(*tree));
 }
 
-CUavlTreeNode *cuAvlTreeNodeFind(CUavlTree *tree, CUavlTreeKey key)
+static int cuAvlTreeCompareU64(CUavlTreeKey a, CUavlTreeKey b)
 {
-    return cuAvlTreeNodeFindWithComparator(tree, key, tree->compare);
+    NvU64 ka = (NvU64)(uintptr_t)a;
+    NvU64 kb = (NvU64)(uintptr_t)b;
+    return (ka > kb) - (ka < kb);
 }
 
-CUavlTreeNode *cuAvlTreeNodeFindGEQ(CUavlTree *tree, CUavlTreeKey key)
+void cuAvlTreeInitializeU64(CUavlTree *tree, CUavlTreePrint print)
 {
-    CUavlTreeNode *node = tree->root;
-    CUavlTreeNode *best = NULL;
-    while (node) {
-        int compare = tree->compare(key, node->key);
-        if (0 >= compare) {
-            best = node;
-        }
-        if (0 == compare) {
-            return node;
-        }
-        node = cuAvlTreeNodeGetChild(tree, node, compare);
-    }
-    return best;
+    cuAvlTreeInitializeWithFlags(tree, cuAvlTreeCompareU64, print, 0);
 }
 
-CUavlTreeNode *cuAvlTreeNodeFindLEQ(CUavlTree *tree, CUavlTreeKey key)
+void cuAvlTreeInitializeU64WithFlags(CUavlTree *tree, CUavlTreePrint print, NvU32 flags)
 {
-    CUavlTreeNode *node = tree->root;
-    CUavlTreeNode *best = NULL;
-    while (node) {
-        int compare = tree->compare(key, node->key);
-        if (0 <= compare) {
-            best = node;
-        }
-        if (0 == compare) {
-            return node;
-        }
-        node = cuAvlTreeNodeGetChild(tree, node, compare);
-    }
-    return best;
+    cuAvlTreeInitializeWithFlags(tree, cuAvlTreeCompareU64, print, flags);
 }
 
-CUavlTreeNode *cuAvlTreeNodeInsertOrReturnExisting(CUavlTree *tree, CUavlTreeNode *node, CUavlTreeKey key, CUavlTreeValue value)
-{
-    CUavlTreeNode *parent = tree->root;
-    CUavlTreeNode **childLink = &tree->root;
-
-    memset(node, 0, sizeof(*node));
-    node->key = key;
-    node->value = value;
-    node->height = 1;
-
-    // Find the node to insert below
-    while (parent) {
-        int compare = tree->compare(key, parent->key);
-        if (0 == compare) {
-            return parent;
-        }
-        childLink = cuAvlTreeNodeGetChildLinkPointer(tree, parent, compare);
-        if (NULL == *childLink) {
-            break;
-        }
-        parent = *childLink;
-    }
-
-    // Link up the node
-    *childLink = node;
-    node->parent = parent;
-    cuAvlTreeNodeRebalance(tree, parent, 0);
-
-#if CU_AVLTREE_DEBUG
-        cuAvlTreeAssertValid(tree);
-#endif
-    return NULL;
+_Static_assert(sizeof(CUavlTreeKey) >= sizeof(NvU64), "NvU64 keys are stored in CUavlTreeKey");
+
+// Lookup and insertion are generated once per key flavour. COMPARE(tree,
+// key, node) returns <0, 0 or >0 like CUavlTreeCompare; TO_KEY turns the
+// key argument into what is stored in node->key. Rotation, removal and
+// iteration never compare keys and are shared.
+#define CU_AVL_TREE_COMPARE_GENERIC(tree, key, node) ((tree)->compare((key), (node)->key))
+#define CU_AVL_TREE_TO_KEY_GENERIC(key)               (key)
+
+// Inline integer comparison on the key stored in node->key; no call
+#define CU_AVL_TREE_COMPARE_U64(tree, key, node) \
+    (((key) > cuAvlTreeNodeKeyU64(node)) - ((key) < cuAvlTreeNodeKeyU64(node)))
+#define CU_AVL_TREE_TO_KEY_U64(key)               ((CUavlTreeKey)(uintptr_t)(key))
+
+#define CU_AVL_TREE_DEFINE_KEYED_OPS(SUFFIX, KEY_TYPE, COMPARE, TO_KEY)                                          \
+CUavlTreeNode *cuAvlTreeNodeFind##SUFFIX(CUavlTree *tree, KEY_TYPE key)                                          \
+{                                                                                                                \
+    CUavlTreeNode *node = tree->root;                                                                            \
+    while (node) {                                                                                               \
+        int compare = COMPARE(tree, key, node);                                                                  \
+        if (0 == compare) {                                                                                      \
+            return node;                                                                                         \
+        }                                                                                                        \
+        node = cuAvlTreeNodeGetChild(tree, node, compare);                                                       \
+    }                                                                                                            \
+    return NULL;                                                                                                 \
+}                                                                                                                \
+                                                                                                                 \
+CUavlTreeNode *cuAvlTreeNodeFindGEQ##SUFFIX(CUavlTree *tree, KEY_TYPE key)                                       \
+{                                                                                                                \
+    CUavlTreeNode *node = tree->root;                                                                            \
+    CUavlTreeNode *best = NULL;                                                                                  \
+    while (node) {                                                                                               \
+        int compare = COMPARE(tree, key, node);                                                                  \
+        if (0 >= compare) {                                                                                      \
+            best = node;                                                                                         \
+        }                                                                                                        \
+        if (0 == compare) {                                                                                      \
+            return node;                                                                                         \
+        }                                                                                                        \
+        node = cuAvlTreeNodeGetChild(tree, node, compare);                                                       \
+    }                                                                                                            \
+    return best;                                                                                                 \
+}                                                                                                                \
+                                                                                                                 \
+CUavlTreeNode *cuAvlTreeNodeFindLEQ##SUFFIX(CUavlTree *tree, KEY_TYPE key)                                       \
+{                                                                                                                \
+    CUavlTreeNode *node = tree->root;                                                                            \
+    CUavlTreeNode *best = NULL;                                                                                  \
+    while (node) {                                                                                               \
+        int compare = COMPARE(tree, key, node);                                                                  \
+        if (0 <= compare) {                                                                                      \
+            best = node;                                                                                         \
+        }                                                                                                        \
+        if (0 == compare) {                                                                                      \
+            return node;                                                                                         \
+        }                                                                                                        \
+        node = cuAvlTreeNodeGetChild(tree, node, compare);                                                       \
+    }                                                                                                            \
+    return best;                                                                                                 \
+}                                                                                                                \
+                                                                                                                 \
+CUavlTreeNode *cuAvlTreeNodeInsertOrReturnExisting##SUFFIX(CUavlTree *tree, CUavlTreeNode *node, KEY_TYPE key,  \
+                                                           CUavlTreeValue value)                                 \
+{                                                                                                                \
+    CUavlTreeNode *parent = tree->root;                                                                          \
+    CUavlTreeNode **childLink = &tree->root;                                                                     \
+                                                                                                                 \
+    memset(node, 0, sizeof(*node));                                                                              \
+    node->key = TO_KEY(key);                                                                                     \
+    node->value = value;                                                                                         \
+    node->height = 1;                                                                                            \
+    node->count = 1;                                                                                             \
+                                                                                                                 \
+    /* Find the node to insert below */                                                                          \
+    while (parent) {                                                                                             \
+        int compare = COMPARE(tree, key, parent);                                                                \
+        if (0 == compare) {                                                                                      \
+            return parent;                                                                                       \
+        }                                                                                                        \
+        childLink = cuAvlTreeNodeGetChildLinkPointer(tree, parent, compare);                                     \
+        if (NULL == *childLink) {                                                                                \
+            break;                                                                                               \
+        }                                                                                                        \
+        parent = *childLink;                                                                                     \
+    }                                                                                                            \
+                                                                                                                 \
+    /* Link up the node */                                                                                       \
+    *childLink = node;                                                                                           \
+    node->parent = parent;                                                                                       \
+    cuAvlTreeNodeRebalance(tree, parent, 0);                                                                     \
+                                                                                                                 \
+    if (CU_AVLTREE_DEBUG) {                                                                                      \
+        cuAvlTreeAssertValid(tree);                                                                              \
+    }                                                                                                            \
+    return NULL;                                                                                                 \
+}                                                                                                                \
+                                                                                                                 \
+CUavlTreeStatus cuAvlTreeNodeInsert##SUFFIX(CUavlTree *tree, CUavlTreeNode *node, KEY_TYPE key,                  \
+                                            CUavlTreeValue value)                                                \
+{                                                                                                                \
+    if (cuAvlTreeNodeInsertOrReturnExisting##SUFFIX(tree, node, key, value) != NULL) {                          \
+        return CU_AVL_TREE_STATUS_KEY_EXISTS;                                                                    \
+    }                                                                                                            \
+    return CU_AVL_TREE_STATUS_SUCCESS;                                                                           \
 }
 
-CUavlTreeStatus cuAvlTreeNodeInsert(CUavlTree *tree, CUavlTreeNode *node, CUavlTreeKey key, CUavlTreeValue value)
-{
-    if (cuAvlTreeNodeInsertOrReturnExisting(tree, node, key, value) != NULL) {
-        return CU_AVL_TREE_STATUS_KEY_EXISTS;
-    }
-    return CU_AVL_TREE_STATUS_SUCCESS;
-}
+CU_AVL_TREE_DEFINE_KEYED_OPS(, CUavlTreeKey, CU_AVL_TREE_COMPARE_GENERIC, CU_AVL_TREE_TO_KEY_GENERIC)
+CU_AVL_TREE_DEFINE_KEYED_OPS(U64, NvU64, CU_AVL_TREE_COMPARE_U64, CU_AVL_TREE_TO_KEY_U64)
 
 void cuAvlTreeNodeRemove(CUavlTree *tree, CUavlTreeNode *node)
 {
@@ -435,4 +505,260 @@ CUavlTreeNode *cuAvlTreeNodeInOrderSuccessor(CUavlTree *tree, CUavlTreeNode *nod
         }
     }
     return NULL;
-}
\ No newline at end of file
+}
+
+static CUavlTreeNode *cuAvlTreeBuildRecursive(CUavlTree *tree, CUavlTreeNode **nodes, size_t first, size_t count,
+                                              CUavlTreeNode *parent)
+{
+    CUavlTreeNode *node;
+    size_t half;
+
+    if (0 == count) {
+        return NULL;
+    }
+    // The left half gets the extra node, so every left subtree is at least
+    // as tall as its sibling and the balance stays 0 or 1
+    half = count / 2;
+    node = nodes[first + half];
+    node->parent = parent;
+    node->left = cuAvlTreeBuildRecursive(tree, nodes, first, half, node);
+    node->right = cuAvlTreeBuildRecursive(tree, nodes, first + half + 1, count - half - 1, node);
+    cuAvlTreeNodeRecalculateHeight(tree, node);
+    return node;
+}
+
+void cuAvlTreeBuildFromSorted(CUavlTree *tree, CUavlTreeNode **nodes, size_t count)
+{
+    CU_ASSERT(NULL == tree->root);
+
+    tree->root = cuAvlTreeBuildRecursive(tree, nodes, 0, count, NULL);
+
+#if CU_AVLTREE_DEBUG
+        cuAvlTreeAssertValid(tree);
+#endif
+}
+
+void cuAvlTreeNodePoolInitialize(CUavlTreeNodePool *pool, size_t nodesPerChunk)
+{
+    CU_ASSERT(0 < nodesPerChunk);
+
+    memset(pool, 0, sizeof(*pool));
+    pool->nodesPerChunk = nodesPerChunk;
+}
+
+void cuAvlTreeNodePoolDeinitialize(CUavlTreeNodePool *pool)
+{
+    CUavlTreeNodePoolChunk *chunk = pool->chunks;
+    while (chunk) {
+        CUavlTreeNodePoolChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(pool, 0, sizeof(*pool));
+}
+
+CUavlTreeNode *cuAvlTreeNodePoolAlloc(CUavlTreeNodePool *pool)
+{
+    CUavlTreeNode *node = pool->freeList;
+
+    // Recycled nodes first, then the unused tail of the newest chunk
+    if (node) {
+        pool->freeList = node->right;
+        return node;
+    }
+    if (pool->chunkUsed == pool->nodesPerChunk || NULL == pool->chunks) {
+        CUavlTreeNodePoolChunk *chunk =
+            (CUavlTreeNodePoolChunk *)malloc(sizeof(*chunk) + pool->nodesPerChunk * sizeof(CUavlTreeNode));
+        if (NULL == chunk) {
+            return NULL;
+        }
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->chunkUsed = 0;
+    }
+    return &pool->chunks->nodes[pool->chunkUsed++];
+}
+
+void cuAvlTreeNodePoolFree(CUavlTreeNodePool *pool, CUavlTreeNode *node)
+{
+    node->right = pool->freeList;
+    pool->freeList = node;
+}
+
+// Joins two subtrees and a pivot whose key lies between them into
+// tree->root. The shorter subtree and the pivot are hung off the spine of
+// the taller one where heights first come within one, then the path above
+// is rebalanced: O(difference in height).
+static void cuAvlTreeJoinWithPivot(CUavlTree *tree, CUavlTreeNode *left, CUavlTreeNode *pivot, CUavlTreeNode *right)
+{
+    int leftHeight = cuAvlTreeNodeGetHeight(tree, left);
+    int rightHeight = cuAvlTreeNodeGetHeight(tree, right);
+    CUavlTreeNode *parent = NULL;
+
+    if (leftHeight > rightHeight + 1) {
+        tree->root = left;
+        left->parent = NULL;
+        while (cuAvlTreeNodeGetHeight(tree, left) > rightHeight + 1) {
+            parent = left;
+            left = left->right;
+        }
+        parent->right = pivot;
+    }
+    else if (rightHeight > leftHeight + 1) {
+        tree->root = right;
+        right->parent = NULL;
+        while (cuAvlTreeNodeGetHeight(tree, right) > leftHeight + 1) {
+            parent = right;
+            right = right->left;
+        }
+        parent->left = pivot;
+    }
+    else {
+        tree->root = pivot;
+    }
+
+    pivot->parent = parent;
+    pivot->left = left;
+    pivot->right = right;
+    if (left) {
+        left->parent = pivot;
+    }
+    if (right) {
+        right->parent = pivot;
+    }
+    cuAvlTreeNodeRecalculateHeight(tree, pivot);
+    cuAvlTreeNodeRebalance(tree, parent, 1);
+}
+
+// Splits the subtree at node into left (keys < key) and right (keys >= key).
+// Each level joins the detached node and its far child onto the side built
+// below it; the join costs telescope to O(height) overall.
+static void cuAvlTreeSplitRecursive(CUavlTree *tree, CUavlTreeNode *node, CUavlTreeKey key, CUavlTree *left,
+                                    CUavlTree *right)
+{
+    CUavlTreeNode *leftChild;
+    CUavlTreeNode *rightChild;
+
+    if (NULL == node) {
+        left->root = NULL;
+        right->root = NULL;
+        return;
+    }
+    leftChild = node->left;
+    rightChild = node->right;
+    if (0 >= tree->compare(key, node->key)) {
+        cuAvlTreeSplitRecursive(tree, leftChild, key, left, right);
+        cuAvlTreeJoinWithPivot(right, right->root, node, rightChild);
+    }
+    else {
+        cuAvlTreeSplitRecursive(tree, rightChild, key, left, right);
+        cuAvlTreeJoinWithPivot(left, leftChild, node, left->root);
+    }
+}
+
+void cuAvlTreeSplit(CUavlTree *tree, CUavlTreeKey key, CUavlTree *left, CUavlTree *right)
+{
+    CUavlTree source = *tree;
+
+    CU_ASSERT(left != right);
+
+    // tree may be passed as left or right, so take its nodes first
+    tree->root = NULL;
+    cuAvlTreeInitializeWithFlags(left, source.compare, source.print, source.flags);
+    cuAvlTreeInitializeWithFlags(right, source.compare, source.print, source.flags);
+    cuAvlTreeSplitRecursive(&source, source.root, key, left, right);
+
+#if CU_AVLTREE_DEBUG
+        cuAvlTreeAssertValid(left);
+        cuAvlTreeAssertValid(right);
+#endif
+}
+
+void cuAvlTreeJoin(CUavlTree *left, CUavlTree *right)
+{
+    CUavlTreeNode *pivot = right->root;
+    CUavlTreeNode *largest;
+
+    if (NULL == pivot) {
+        return;
+    }
+    if (NULL == left->root) {
+        left->root = right->root;
+        right->root = NULL;
+        return;
+    }
+
+    // The smallest key on the right becomes the pivot between the two
+    while (pivot->left) {
+        pivot = pivot->left;
+    }
+    largest = left->root;
+    while (largest->right) {
+        largest = largest->right;
+    }
+    CU_ASSERT(0 < left->compare(pivot->key, largest->key));
+    cuAvlTreeNodeRemove(right, pivot);
+    cuAvlTreeJoinWithPivot(left, left->root, pivot, right->root);
+    right->root = NULL;
+
+#if CU_AVLTREE_DEBUG
+        cuAvlTreeAssertValid(left);
+#endif
+}
+
+NvU64 cuAvlTreeCount(CUavlTree *tree)
+{
+    CU_ASSERT(tree->flags & CU_AVL_TREE_FLAG_COUNTS);
+    return cuAvlTreeNodeGetCount(tree, tree->root);
+}
+
+NvU64 cuAvlTreeRank(CUavlTree *tree, CUavlTreeKey key)
+{
+    CUavlTreeNode *node = tree->root;
+    NvU64 rank = 0;
+
+    CU_ASSERT(tree->flags & CU_AVL_TREE_FLAG_COUNTS);
+
+    // Every step right passes over the node and its left subtree
+    while (node) {
+        int compare = tree->compare(key, node->key);
+        if (0 < compare) {
+            rank += 1 + cuAvlTreeNodeGetCount(tree, node->left);
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+    return rank;
+}
+
+CUavlTreeNode *cuAvlTreeSelect(CUavlTree *tree, NvU64 k)
+{
+    CUavlTreeNode *node = tree->root;
+
+    CU_ASSERT(tree->flags & CU_AVL_TREE_FLAG_COUNTS);
+
+    while (node) {
+        NvU64 leftCount = cuAvlTreeNodeGetCount(tree, node->left);
+        if (k < leftCount) {
+            node = node->left;
+        }
+        else if (k == leftCount) {
+            return node;
+        }
+        else {
+            k -= leftCount + 1;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+NvU64 cuAvlTreeCountRange(CUavlTree *tree, CUavlTreeKey lo, CUavlTreeKey hi)
+{
+    if (0 <= tree->compare(lo, hi)) {
+        return 0;
+    }
+    return cuAvlTreeRank(tree, hi) - cuAvlTreeRank(tree, lo);
+}
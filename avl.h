@@ -41,6 +41,7 @@ struct CUavlTreeNode_st
     CUavlTreeValue value;
     CUavlTreeNode *parent;
     int            height;
+    NvU32          count;   // Nodes in this subtree (CU_AVL_TREE_FLAG_COUNTS only)
 };
 
 struct CUavlTree_st
@@ -48,11 +49,15 @@ struct CUavlTree_st
     CUavlTreePrint   print;
     CUavlTreeCompare compare;
     CUavlTreeNode   *root;
+    NvU32            flags;
 };
 
+#define CU_AVL_TREE_FLAG_COUNTS 0x1  // Maintain per-subtree node counts for rank/select
+
 void            cuAvlTreeAssertValid(CUavlTree *tree);
 
 void            cuAvlTreeInitialize(CUavlTree *tree, CUavlTreeCompare compare, CUavlTreePrint print);
+void            cuAvlTreeInitializeWithFlags(CUavlTree *tree, CUavlTreeCompare compare, CUavlTreePrint print, NvU32 flags);
 void            cuAvlTreeDeinitialize(CUavlTree *tree);
 CUavlTreeNode  *cuAvlTreeNodeFind(CUavlTree *tree, CUavlTreeKey key);
 CUavlTreeNode  *cuAvlTreeNodeFindGEQ(CUavlTree *tree, CUavlTreeKey key);
@@ -63,6 +68,75 @@ void            cuAvlTreeNodeRemove(CUavlTree *tree, CUavlTreeNode *node);
 CUavlTreeNode  *cuAvlTreeNodeInOrderPredecessor(CUavlTree *tree, CUavlTreeNode *node);
 CUavlTreeNode  *cuAvlTreeNodeInOrderSuccessor(CUavlTree *tree, CUavlTreeNode *node);
 
+// Trees keyed by an NvU64 stored directly in node->key. The *U64 lookups
+// and inserts compare keys inline instead of through tree->compare; the
+// tree's compare function is still set (to an integer comparison) so the
+// generic calls, with keys passed as (CUavlTreeKey)(uintptr_t)key, and
+// cuAvlTreeAssertValid work on the same tree. Remove and the in-order walks
+// are shared with the generic tree.
+static inline NvU64 cuAvlTreeNodeKeyU64(const CUavlTreeNode *node)
+{
+    return (NvU64)(uintptr_t)node->key;
+}
+
+void            cuAvlTreeInitializeU64(CUavlTree *tree, CUavlTreePrint print);
+void            cuAvlTreeInitializeU64WithFlags(CUavlTree *tree, CUavlTreePrint print, NvU32 flags);
+CUavlTreeNode  *cuAvlTreeNodeFindU64(CUavlTree *tree, NvU64 key);
+CUavlTreeNode  *cuAvlTreeNodeFindGEQU64(CUavlTree *tree, NvU64 key);
+CUavlTreeNode  *cuAvlTreeNodeFindLEQU64(CUavlTree *tree, NvU64 key);
+CUavlTreeStatus cuAvlTreeNodeInsertU64(CUavlTree *tree, CUavlTreeNode *node, NvU64 key, CUavlTreeValue value);
+CUavlTreeNode  *cuAvlTreeNodeInsertOrReturnExistingU64(CUavlTree *tree, CUavlTreeNode *node, NvU64 key, CUavlTreeValue value);
+
+// Links nodes[0..count) into an empty tree as a perfectly balanced tree in
+// O(n), without comparisons or rotations. The nodes' key and value must be
+// set, and keys must be strictly increasing under the tree's compare.
+void            cuAvlTreeBuildFromSorted(CUavlTree *tree, CUavlTreeNode **nodes, size_t count);
+
+// Moves the keys < key into left and the keys >= key into right, leaving
+// tree empty; left and right are (re)initialized with tree's compare and
+// print, and tree may itself be passed as either. O(log n).
+void            cuAvlTreeSplit(CUavlTree *tree, CUavlTreeKey key, CUavlTree *left, CUavlTree *right);
+
+// Moves every node of right into left, leaving right empty. All keys in
+// left must be smaller than all keys in right. O(log n).
+void            cuAvlTreeJoin(CUavlTree *left, CUavlTree *right);
+
+// Order statistics, for trees initialized with CU_AVL_TREE_FLAG_COUNTS. The
+// counts ride along with the height updates, so every operation above keeps
+// them current. cuAvlTreeRank returns the number of keys < key,
+// cuAvlTreeSelect the node with k keys before it (NULL if k >= count), and
+// cuAvlTreeCountRange the number of keys in [lo, hi). All are O(log n).
+NvU64           cuAvlTreeCount(CUavlTree *tree);
+NvU64           cuAvlTreeRank(CUavlTree *tree, CUavlTreeKey key);
+CUavlTreeNode  *cuAvlTreeSelect(CUavlTree *tree, NvU64 k);
+NvU64           cuAvlTreeCountRange(CUavlTree *tree, CUavlTreeKey lo, CUavlTreeKey hi);
+
+// Node pool: nodes are carved from malloc'd chunks of nodesPerChunk and
+// recycled through a free list threaded through node->right. Deinitialize
+// releases every chunk at once, so nodes still linked into a tree must not
+// be used afterwards; there is no need to remove or free them one by one.
+typedef struct CUavlTreeNodePoolChunk_st CUavlTreeNodePoolChunk;
+typedef struct CUavlTreeNodePool_st CUavlTreeNodePool;
+
+struct CUavlTreeNodePoolChunk_st
+{
+    CUavlTreeNodePoolChunk *next;
+    CUavlTreeNode           nodes[];
+};
+
+struct CUavlTreeNodePool_st
+{
+    CUavlTreeNodePoolChunk *chunks;     // Newest first
+    CUavlTreeNode          *freeList;
+    size_t                  chunkUsed;  // Nodes handed out from the newest chunk
+    size_t                  nodesPerChunk;
+};
+
+void            cuAvlTreeNodePoolInitialize(CUavlTreeNodePool *pool, size_t nodesPerChunk);
+void            cuAvlTreeNodePoolDeinitialize(CUavlTreeNodePool *pool);
+CUavlTreeNode  *cuAvlTreeNodePoolAlloc(CUavlTreeNodePool *pool);
+void            cuAvlTreeNodePoolFree(CUavlTreeNodePool *pool, CUavlTreeNode *node);
+
 CUavlTreeNode *cuAvlTreeNodeFindWithNodeComparator(CUavlTree *tree, CUavlTreeKey key, CUavlTreeNodeCompare comparator);
 CUavlTreeNode *cuAvlTreeNodeFindWithComparator(CUavlTree *tree, CUavlTreeKey key, CUavlTreeCompare comparator);
 
@@ -6,14 +6,47 @@
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <fstream>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 
 extern "C" {
 #include "radix.h"
+#include "radix_concurrent.h"
+#include "radix_interval.h"
+#include "radix_compact.h"
+#include "radix_stride.h"
+#include "radix_critbit.h"
+#include "va_allocator.h"
 #include "wide_radix.h"
 #include "art.h"
 #include "avl.h"
 #include "radix_new.h"
 }
+#include "radix_new.hpp"
+
+// Compile-time counterpart of treeInit(&tree, 64, 8): 56 key bits, 8 bits per level
+typedef WideRadix<56, 8, uint64_t> RadixNewTemplate;
+
+// Set by --large: run the long-running workloads at their full size
+static bool g_large_runs = false;
+
+// Resident set size of this process, or 0 where /proc is unavailable
+static size_t current_rss_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * (size_t)sysconf(_SC_PAGESIZE);
+    }
+    return 0;
+}
 
 class Timer {
 public:
@@ -30,6 +63,45 @@ private:
     std::chrono::high_resolution_clock::time_point start_time;
 };
 
+// Branch misses of the calling thread between start() and stop(). stop()
+// returns -1 where hardware perf events aren't available (VMs, containers,
+// perf_event_paranoid).
+class BranchMissCounter {
+public:
+    BranchMissCounter() {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    
+    ~BranchMissCounter() {
+        if (fd >= 0) close(fd);
+    }
+    
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    
+    long long stop() {
+        long long count;
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+    
+private:
+    int fd;
+};
+
 void benchmark_radix_tree(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
     Timer timer;
     CUradixTree tree;
@@ -151,14 +223,142 @@ void benchmark_wide_radix(const std::vector<NvU64>& keys, const std::vector<NvU6
     double insert_time_per_op = (insert_time * 1000.0) / keys.size();  // Convert to microseconds per operation
     double lookup_time_per_op = (lookup_time * 1000.0) / search_keys.size();  // Convert to microseconds per operation
     
+    // Memory per distinct key, compared with the original layout of fixed
+    // 256-slot nodes plus one such node per key as its leaf
+    size_t num_nodes = 0;
+    size_t bytes = wide_radix_memory_usage(&tree, &num_nodes);
+    std::set<NvU64> unique_keys(keys.begin(), keys.end());
+    size_t num_unique = unique_keys.size();
+    const size_t fixed_node_bytes = sizeof(wide_radix_mask_t) + 256 * sizeof(void*) + sizeof(NvU64) + sizeof(NvU64);
+    
     std::cout << "Wide Radix Tree Results:\n";
     std::cout << "  Insertion: " << std::fixed << std::setprecision(3) << insert_time_per_op << " us/op\n";
     std::cout << "  Lookup:    " << std::fixed << std::setprecision(3) << lookup_time_per_op << " us/op\n";
-    std::cout << "  Found:     " << found_count << "/" << search_keys.size() << " keys\n\n";
+    std::cout << "  Found:     " << found_count << "/" << search_keys.size() << " keys\n";
+    std::cout << "  Memory:    " << std::fixed << std::setprecision(1) << (double)bytes / num_unique
+              << " bytes/key (fixed 256-slot nodes with leaf nodes: "
+              << (double)((num_nodes + num_unique) * fixed_node_bytes) / num_unique << " bytes/key)\n\n";
+    
+    wide_radix_destroy(&tree);
+}
+
+void benchmark_wide_radix_churn(size_t working_set, size_t cycles) {
+    Timer timer;
+    wide_radix_tree_t tree;
+    wide_radix_init(&tree, 64);
+    
+    // Sparse random keys, so every replacement creates and prunes whole paths
+    std::mt19937_64 gen(1234);
+    std::vector<NvU64> live_keys(working_set);
+    for (auto& key : live_keys) {
+        key = gen();
+        wide_radix_insert(&tree, key, key);
+    }
+    
+    std::cout << "Wide Radix Tree Churn (" << working_set << " live keys, " << cycles << " delete+insert cycles):\n";
+    timer.start();
+    for (size_t cycle = 1; cycle <= cycles; ++cycle) {
+        NvU64& key = live_keys[gen() % working_set];
+        wide_radix_delete(&tree, key);
+        key = gen();
+        wide_radix_insert(&tree, key, key);
+        
+        if (cycle % (cycles / 5) == 0) {
+            std::cout << "  " << std::setw(10) << cycle << " cycles: tree " << wide_radix_memory_usage(&tree, NULL) / 1024
+                      << " KB, RSS " << current_rss_bytes() / 1024 << " KB\n";
+        }
+    }
+    double churn_time = timer.stop();
+    std::cout << "  Cycle:     " << std::fixed << std::setprecision(3) << (churn_time * 1000.0) / cycles << " us/op\n\n";
     
     wide_radix_destroy(&tree);
 }
 
+// Build, reset and destroy time for malloc-backed and arena-backed trees.
+// Keys are spread over 64x their count, like page-granular allocations.
+void benchmark_wide_radix_teardown(size_t num_keys) {
+    std::mt19937_64 gen(num_keys);
+    std::vector<NvU64> keys(num_keys);
+    for (auto& key : keys) {
+        key = gen() % (num_keys * 64);
+    }
+    
+    std::cout << "  " << std::setw(9) << num_keys << " keys:\n";
+    const NvU32 modes[2] = {0, WIDE_RADIX_FLAG_ARENA};
+    for (NvU32 flags : modes) {
+        Timer timer;
+        wide_radix_tree_t tree;
+        wide_radix_init_with_flags(&tree, 64, flags);
+        
+        timer.start();
+        for (const auto& key : keys) {
+            wide_radix_insert(&tree, key, key);
+        }
+        double build_time = timer.stop();
+        size_t num_nodes = 0;
+        size_t bytes = wide_radix_memory_usage(&tree, &num_nodes);
+        
+        timer.start();
+        wide_radix_reset(&tree);
+        double reset_time = timer.stop();
+        
+        // Rebuild so destroy sees a full tree again
+        for (const auto& key : keys) {
+            wide_radix_insert(&tree, key, key);
+        }
+        timer.start();
+        wide_radix_destroy(&tree);
+        double destroy_time = timer.stop();
+        
+        std::cout << "    " << (flags ? "arena " : "malloc") << ": build " << std::fixed << std::setprecision(1)
+                  << build_time << " ms, reset " << std::setprecision(3) << reset_time << " ms, destroy "
+                  << destroy_time << " ms (" << num_nodes << " nodes, " << bytes / (1024 * 1024) << " MB)\n";
+    }
+}
+
+// Lookup latency for keys of the given width, with the level count derived
+// from key_bits and with the full 8 levels of a 64-bit tree
+void benchmark_wide_radix_key_width(NvU32 key_bits, size_t num_keys) {
+    std::mt19937_64 gen(key_bits);
+    NvU64 mask = key_bits == 64 ? ~0ULL : (1ULL << key_bits) - 1;
+    std::vector<NvU64> keys(num_keys);
+    for (auto& key : keys) {
+        key = gen() & mask;
+    }
+    std::vector<NvU64> search_keys(keys);
+    std::shuffle(search_keys.begin(), search_keys.end(), gen);
+    
+    double lookup_us[2];
+    NvU32 levels[2];
+    size_t missing = 0;
+    const NvU32 widths[2] = {key_bits, 64};
+    for (int i = 0; i < 2; ++i) {
+        wide_radix_tree_t tree;
+        wide_radix_init(&tree, widths[i]);
+        for (const auto& key : keys) {
+            wide_radix_insert(&tree, key, key);
+        }
+        
+        Timer timer;
+        timer.start();
+        size_t found_count = 0;
+        for (const auto& key : search_keys) {
+            if (wide_radix_lookup(&tree, key)) {
+                found_count++;
+            }
+        }
+        lookup_us[i] = (timer.stop() * 1000.0) / search_keys.size();
+        levels[i] = tree.num_levels;
+        missing += search_keys.size() - found_count;
+        wide_radix_destroy(&tree);
+    }
+    
+    std::cout << "  " << std::setw(2) << key_bits << "-bit keys: " << std::fixed << std::setprecision(3)
+              << lookup_us[0] << " us/op (" << levels[0] << " levels), "
+              << lookup_us[1] << " us/op (" << levels[1] << " levels)"
+              << (missing ? ", MISSING KEYS: " + std::to_string(missing) : std::string()) << "\n";
+}
+
 void benchmark_radix_new(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
     Timer timer;
     WideRadixTree tree;
@@ -197,6 +397,203 @@ void benchmark_radix_new(const std::vector<NvU64>& keys, const std::vector<NvU64
     treeDestroy(&tree);
 }
 
+void benchmark_radix_new_template(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
+    Timer timer;
+    RadixNewTemplate tree;
+    
+    // Benchmark insertion
+    timer.start();
+    for (const auto& key : keys) {
+        uint64_t* existing;
+        int result = tree.insertOrReturnExisting(key, key, &existing);  // Use key as value
+        if (result != 0) {
+            std::cerr << "Warning: Failed to insert key " << key << " in radix_new template tree\n";
+        }
+    }
+    double insert_time = timer.stop();
+    
+    // Benchmark lookup
+    timer.start();
+    size_t found_count = 0;
+    for (const auto& key : search_keys) {
+        if (tree.find(key) != nullptr) {
+            found_count++;
+        }
+    }
+    double lookup_time = timer.stop();
+    
+    double insert_time_per_op = (insert_time * 1000.0) / keys.size();  // Convert to microseconds per operation
+    double lookup_time_per_op = (lookup_time * 1000.0) / search_keys.size();  // Convert to microseconds per operation
+    
+    std::cout << "Radix New Template Results:\n";
+    std::cout << "  Insertion: " << std::fixed << std::setprecision(3) << insert_time_per_op << " us/op\n";
+    std::cout << "  Lookup:    " << std::fixed << std::setprecision(3) << lookup_time_per_op << " us/op\n";
+    std::cout << "  Found:     " << found_count << "/" << search_keys.size() << " keys\n\n";
+}
+
+void benchmark_radix_new_counts(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
+    Timer timer;
+    WideRadixTree plain_tree, counted_tree;
+    treeInit(&plain_tree, 64, 8);
+    treeInitWithFlags(&counted_tree, 64, 8, TREE_FLAG_COUNTS);
+    
+    // Cost of maintaining the subtree counters on insert/remove
+    timer.start();
+    for (const auto& key : keys) {
+        uint64_t existing;
+        treeInsertOrReturnExisting(&plain_tree, key, key, &existing);
+    }
+    double plain_insert_time = timer.stop();
+    
+    timer.start();
+    for (const auto& key : keys) {
+        uint64_t existing;
+        treeInsertOrReturnExisting(&counted_tree, key, key, &existing);
+    }
+    double counted_insert_time = timer.stop();
+    
+    // Order statistic queries (O(levels))
+    timer.start();
+    uint64_t rank_sum = 0;
+    for (const auto& key : search_keys) {
+        rank_sum += treeRank(&counted_tree, key);
+    }
+    double rank_time = timer.stop();
+    
+    uint64_t total = treeCount(&counted_tree);
+    timer.start();
+    size_t select_found = 0;
+    for (size_t i = 0; i < search_keys.size(); ++i) {
+        uint64_t key;
+        if (treeSelect(&counted_tree, (search_keys[i] * 2654435761ULL) % total, &key) == 0) {
+            select_found++;
+        }
+    }
+    double select_time = timer.stop();
+    
+    timer.start();
+    uint64_t range_sum = 0;
+    for (const auto& key : search_keys) {
+        range_sum += treeCountRange(&counted_tree, key, key + 10000);
+    }
+    double range_time = timer.stop();
+    
+    // Same range count on std::set needs a scan of the range
+    std::set<NvU64> std_set(keys.begin(), keys.end());
+    timer.start();
+    uint64_t set_range_sum = 0;
+    for (const auto& key : search_keys) {
+        set_range_sum += std::distance(std_set.lower_bound(key), std_set.lower_bound(key + 10000));
+    }
+    double set_range_time = timer.stop();
+    
+    timer.start();
+    for (const auto& key : keys) {
+        treeRemove(&plain_tree, key);
+    }
+    double plain_remove_time = timer.stop();
+    
+    timer.start();
+    for (const auto& key : keys) {
+        treeRemove(&counted_tree, key);
+    }
+    double counted_remove_time = timer.stop();
+    
+    std::cout << "Radix New Tree Order Statistics (TREE_FLAG_COUNTS):\n";
+    std::cout << "  Insertion:   " << std::fixed << std::setprecision(3) << (plain_insert_time * 1000.0) / keys.size()
+              << " us/op plain, " << (counted_insert_time * 1000.0) / keys.size() << " us/op counted\n";
+    std::cout << "  Removal:     " << std::fixed << std::setprecision(3) << (plain_remove_time * 1000.0) / keys.size()
+              << " us/op plain, " << (counted_remove_time * 1000.0) / keys.size() << " us/op counted\n";
+    std::cout << "  Rank:        " << std::fixed << std::setprecision(3) << (rank_time * 1000.0) / search_keys.size() << " us/op\n";
+    std::cout << "  Select:      " << std::fixed << std::setprecision(3) << (select_time * 1000.0) / search_keys.size()
+              << " us/op (" << select_found << " found)\n";
+    std::cout << "  CountRange:  " << std::fixed << std::setprecision(3) << (range_time * 1000.0) / search_keys.size()
+              << " us/op (std::set distance: " << (set_range_time * 1000.0) / search_keys.size() << " us/op, "
+              << (range_sum == set_range_sum ? "match" : "MISMATCH") << ")\n\n";
+    
+    treeDestroy(&plain_tree);
+    treeDestroy(&counted_tree);
+}
+
+template <size_t PayloadBytes>
+struct BenchPayload {
+    uint64_t words[PayloadBytes / sizeof(uint64_t)];
+};
+
+// Leaf value is a pointer to a separately allocated payload vs payload stored inline in the leaf
+template <size_t PayloadBytes>
+void benchmark_radix_new_payload(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
+    typedef BenchPayload<PayloadBytes> Payload;
+    Timer timer;
+    
+    // Allocate the out-of-line payloads in shuffled order so they are scattered like heap objects
+    std::vector<NvU64> unique_keys(keys);
+    unique_keys.erase(std::unique(unique_keys.begin(), unique_keys.end()), unique_keys.end());
+    std::vector<NvU64> alloc_order(unique_keys);
+    std::shuffle(alloc_order.begin(), alloc_order.end(), std::mt19937(PayloadBytes));
+    std::vector<Payload*> payloads;
+    payloads.reserve(alloc_order.size());
+    
+    WideRadixTree pointer_tree;
+    treeInit(&pointer_tree, 64, 8);
+    for (const auto& key : alloc_order) {
+        Payload* payload = new Payload();
+        for (auto& word : payload->words) {
+            word = key;
+        }
+        payloads.push_back(payload);
+        uint64_t existing;
+        treeInsertOrReturnExisting(&pointer_tree, key, (uint64_t)payload, &existing);
+    }
+    
+    WideRadixTree inline_tree;
+    treeInitWithValueSize(&inline_tree, 64, 8, sizeof(Payload), 0);
+    for (const auto& key : unique_keys) {
+        Payload payload;
+        for (auto& word : payload.words) {
+            word = key;
+        }
+        void* slot;
+        treeInsertPayload(&inline_tree, key, &payload, &slot);
+    }
+    
+    // Lookups read the whole payload
+    timer.start();
+    uint64_t pointer_sum = 0;
+    for (const auto& key : search_keys) {
+        Payload* payload = (Payload*)treeFind(&pointer_tree, key);
+        if (payload) {
+            for (const auto& word : payload->words) {
+                pointer_sum += word;
+            }
+        }
+    }
+    double pointer_time = timer.stop();
+    
+    timer.start();
+    uint64_t inline_sum = 0;
+    for (const auto& key : search_keys) {
+        Payload* payload = (Payload*)treeFindPayload(&inline_tree, key);
+        if (payload) {
+            for (const auto& word : payload->words) {
+                inline_sum += word;
+            }
+        }
+    }
+    double inline_time = timer.stop();
+    
+    std::cout << "  " << std::setw(2) << PayloadBytes << "-byte payload: " << std::fixed << std::setprecision(3)
+              << (pointer_time * 1000.0) / search_keys.size() << " us/op pointer, "
+              << (inline_time * 1000.0) / search_keys.size() << " us/op inline"
+              << (pointer_sum == inline_sum ? "" : " (MISMATCH)") << "\n";
+    
+    treeDestroy(&pointer_tree);
+    treeDestroy(&inline_tree);
+    for (auto* payload : payloads) {
+        delete payload;
+    }
+}
+
 void benchmark_libart(const std::vector<NvU64>& keys, const std::vector<NvU64>& search_keys) {
     Timer timer;
     art_tree tree;
@@ -258,11 +655,13 @@ void benchmark_avl_tree(const std::vector<NvU64>& keys, const std::vector<NvU64>
     };
     
     cuAvlTreeInitialize(&tree, compare_func, print_func);
+    CUavlTreeNodePool pool;
+    cuAvlTreeNodePoolInitialize(&pool, 4096);
     
     // Benchmark insertion
     timer.start();
     for (const auto& key : keys) {
-        CUavlTreeNode* node = (CUavlTreeNode*)malloc(sizeof(CUavlTreeNode));
+        CUavlTreeNode* node = cuAvlTreeNodePoolAlloc(&pool);
         if (node) {
             node->key = (void*)&key;
             node->value = (void*)&key;  // Use key as value
@@ -291,100 +690,1648 @@ void benchmark_avl_tree(const std::vector<NvU64>& keys, const std::vector<NvU64>
     std::cout << "  Found:     " << found_count << "/" << search_keys.size() << " keys\n\n";
     
     cuAvlTreeDeinitialize(&tree);
+    cuAvlTreeNodePoolDeinitialize(&pool);
 }
 
-void benchmark_range_queries(const std::vector<NvU64>& keys) {
+// Building a CUavlTree from sorted unique keys: malloc'd nodes inserted one
+// by one (the path benchmark_avl_tree took), pooled nodes inserted one by
+// one, and pooled nodes linked by cuAvlTreeBuildFromSorted. Lookups then run
+// on the incrementally built tree and on the perfectly balanced one.
+void benchmark_avl_bulk_build(const char* name, std::vector<NvU64> keys, const std::vector<NvU64>& queries) {
     Timer timer;
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
     
-    // Setup data structures
-    CUradixTree radix_tree;
-    std::vector<CUradixNode> nodes(keys.size());
-    radixTreeInit(&radix_tree, 64);
-    
-    WideRadixTree radix_new_tree;
-    treeInit(&radix_new_tree, 64, 8);
+    CUavlTree malloc_tree;
+    std::vector<CUavlTreeNode*> malloc_nodes;
+    malloc_nodes.reserve(keys.size());
+    cuAvlTreeInitializeU64(&malloc_tree, [](CUavlTreeKey) {});
+    timer.start();
+    for (const auto& key : keys) {
+        CUavlTreeNode* node = (CUavlTreeNode*)malloc(sizeof(CUavlTreeNode));
+        cuAvlTreeNodeInsertU64(&malloc_tree, node, key, NULL);
+        malloc_nodes.push_back(node);
+    }
+    double malloc_insert_time = timer.stop();
+    timer.start();
+    for (CUavlTreeNode* node : malloc_nodes) {
+        free(node);
+    }
+    double malloc_free_time = timer.stop();
+    cuAvlTreeDeinitialize(&malloc_tree);
     
-    std::set<NvU64> std_set;
+    CUavlTree insert_tree;
+    CUavlTreeNodePool insert_pool;
+    cuAvlTreeInitializeU64(&insert_tree, [](CUavlTreeKey) {});
+    cuAvlTreeNodePoolInitialize(&insert_pool, 4096);
+    timer.start();
+    for (const auto& key : keys) {
+        cuAvlTreeNodeInsertU64(&insert_tree, cuAvlTreeNodePoolAlloc(&insert_pool), key, NULL);
+    }
+    double pool_insert_time = timer.stop();
     
+    CUavlTree build_tree;
+    CUavlTreeNodePool build_pool;
+    std::vector<CUavlTreeNode*> build_nodes(keys.size());
+    cuAvlTreeInitializeU64(&build_tree, [](CUavlTreeKey) {});
+    cuAvlTreeNodePoolInitialize(&build_pool, 4096);
+    timer.start();
     for (size_t i = 0; i < keys.size(); ++i) {
-        radixTreeInsert(&radix_tree, &nodes[i], keys[i]);
-        uint64_t existing;
-        treeInsertOrReturnExisting(&radix_new_tree, keys[i], keys[i], &existing);
-        std_set.insert(keys[i]);
+        build_nodes[i] = cuAvlTreeNodePoolAlloc(&build_pool);
+        build_nodes[i]->key = (CUavlTreeKey)(uintptr_t)keys[i];
+        build_nodes[i]->value = NULL;
     }
+    cuAvlTreeBuildFromSorted(&build_tree, build_nodes.data(), build_nodes.size());
+    double build_time = timer.stop();
     
-    // Test range queries (find smallest element >= query)
-    std::vector<NvU64> query_keys;
-    for (size_t i = 0; i < 10000; ++i) {
-        query_keys.push_back(keys[i % keys.size()] + (i % 100));
+    timer.start();
+    NvU64 insert_sum = 0;
+    for (const auto& query : queries) {
+        CUavlTreeNode* found = cuAvlTreeNodeFindGEQU64(&insert_tree, query);
+        if (found) insert_sum += cuAvlTreeNodeKeyU64(found);
     }
-    
-    // Radix tree range queries
+    double insert_lookup_time = timer.stop();
     timer.start();
-    size_t radix_found = 0;
-    for (const auto& query : query_keys) {
-        CUradixNode* found = radixTreeFindGEQ(&radix_tree, query);
-        if (found) radix_found++;
+    NvU64 build_sum = 0;
+    for (const auto& query : queries) {
+        CUavlTreeNode* found = cuAvlTreeNodeFindGEQU64(&build_tree, query);
+        if (found) build_sum += cuAvlTreeNodeKeyU64(found);
     }
-    double radix_range_time = timer.stop();
+    double build_lookup_time = timer.stop();
     
-    // New Radix tree range queries
+    int insert_height = insert_tree.root ? insert_tree.root->height : 0;
+    int build_height = build_tree.root ? build_tree.root->height : 0;
     timer.start();
-    size_t radix_new_found = 0;
-    for (const auto& query : query_keys) {
-        uint64_t found = treeFindGEQ(&radix_new_tree, query);
-        if (found != 0) radix_new_found++;
-    }
-    double radix_new_range_time = timer.stop();
+    cuAvlTreeNodePoolDeinitialize(&insert_pool);
+    double pool_free_time = timer.stop();
+    cuAvlTreeNodePoolDeinitialize(&build_pool);
+    cuAvlTreeDeinitialize(&insert_tree);
+    cuAvlTreeDeinitialize(&build_tree);
     
-    // std::set range queries
+    std::cout << "  " << name << " (" << keys.size() << " sorted unique keys):\n";
+    std::cout << "    Build (us/node):  malloc+insert " << std::fixed << std::setprecision(3)
+              << (malloc_insert_time * 1000.0) / keys.size() << ", pool+insert "
+              << (pool_insert_time * 1000.0) / keys.size() << ", pool+BuildFromSorted "
+              << (build_time * 1000.0) / keys.size() << "\n";
+    std::cout << "    Free (ms total):  " << std::fixed << std::setprecision(3) << malloc_free_time
+              << " individual vs " << pool_free_time << " pool\n";
+    std::cout << "    FindGEQ (us/op):  incremental " << std::fixed << std::setprecision(3)
+              << (insert_lookup_time * 1000.0) / queries.size() << " (height " << insert_height
+              << "), BuildFromSorted " << (build_lookup_time * 1000.0) / queries.size() << " (height "
+              << build_height << ") (" << (insert_sum == build_sum ? "results match" : "RESULTS DIFFER") << ")\n";
+}
+
+// Generic CUavlTree (keys behind pointers, compared through tree->compare)
+// vs the NvU64-keyed variant that stores the key in the node and compares
+// it inline; the tree shape and rebalancing are identical
+void benchmark_avl_u64(const char* name, const std::vector<NvU64>& keys, const std::vector<NvU64>& queries) {
+    Timer timer;
+    auto compare_func = [](CUavlTreeKey a, CUavlTreeKey b) -> int {
+        NvU64 key_a = *(NvU64*)a;
+        NvU64 key_b = *(NvU64*)b;
+        if (key_a < key_b) return -1;
+        if (key_a > key_b) return 1;
+        return 0;
+    };
+    
+    CUavlTree generic_tree;
+    std::vector<CUavlTreeNode> generic_nodes(keys.size());
+    cuAvlTreeInitialize(&generic_tree, compare_func, [](CUavlTreeKey) {});
     timer.start();
-    size_t set_found = 0;
-    for (const auto& query : query_keys) {
-        auto it = std_set.lower_bound(query);
-        if (it != std_set.end()) set_found++;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        cuAvlTreeNodeInsert(&generic_tree, &generic_nodes[i], (void*)&keys[i], (void*)&keys[i]);
     }
-    double set_range_time = timer.stop();
+    double generic_insert_time = timer.stop();
+    timer.start();
+    size_t generic_found = 0;
+    for (const auto& query : queries) {
+        if (cuAvlTreeNodeFind(&generic_tree, (void*)&query)) generic_found++;
+    }
+    double generic_find_time = timer.stop();
+    timer.start();
+    NvU64 generic_sum = 0;
+    for (const auto& query : queries) {
+        CUavlTreeNode* found = cuAvlTreeNodeFindGEQ(&generic_tree, (void*)&query);
+        if (found) generic_sum += *(NvU64*)found->key;
+    }
+    double generic_geq_time = timer.stop();
     
-    double radix_range_time_per_op = (radix_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
-    double radix_new_range_time_per_op = (radix_new_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
-    double set_range_time_per_op = (set_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    CUavlTree u64_tree;
+    std::vector<CUavlTreeNode> u64_nodes(keys.size());
+    cuAvlTreeInitializeU64(&u64_tree, [](CUavlTreeKey) {});
+    timer.start();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        cuAvlTreeNodeInsertU64(&u64_tree, &u64_nodes[i], keys[i], (void*)&keys[i]);
+    }
+    double u64_insert_time = timer.stop();
+    timer.start();
+    size_t u64_found = 0;
+    for (const auto& query : queries) {
+        if (cuAvlTreeNodeFindU64(&u64_tree, query)) u64_found++;
+    }
+    double u64_find_time = timer.stop();
+    timer.start();
+    NvU64 u64_sum = 0;
+    for (const auto& query : queries) {
+        CUavlTreeNode* found = cuAvlTreeNodeFindGEQU64(&u64_tree, query);
+        if (found) u64_sum += cuAvlTreeNodeKeyU64(found);
+    }
+    double u64_geq_time = timer.stop();
     
-    std::cout << "Range Query Results (lower_bound/GEQ):\n";
-    std::cout << "  Radix Tree:     " << std::fixed << std::setprecision(3) << radix_range_time_per_op << " us/op (" << radix_found << " found)\n";
-    std::cout << "  Radix New Tree: " << std::fixed << std::setprecision(3) << radix_new_range_time_per_op << " us/op (" << radix_new_found << " found)\n";
-    std::cout << "  std::set:       " << std::fixed << std::setprecision(3) << set_range_time_per_op << " us/op (" << set_found << " found)\n\n";
+    std::cout << "  " << name << " (" << keys.size() << " keys; insert / Find / FindGEQ):\n";
+    std::cout << "    Generic (comparator): " << std::fixed << std::setprecision(3)
+              << (generic_insert_time * 1000.0) / keys.size() << " / " << (generic_find_time * 1000.0) / queries.size()
+              << " / " << (generic_geq_time * 1000.0) / queries.size() << " us/op\n";
+    std::cout << "    NvU64 (inline):       " << std::fixed << std::setprecision(3)
+              << (u64_insert_time * 1000.0) / keys.size() << " / " << (u64_find_time * 1000.0) / queries.size()
+              << " / " << (u64_geq_time * 1000.0) / queries.size() << " us/op ("
+              << (generic_found == u64_found && generic_sum == u64_sum ? "results match" : "RESULTS DIFFER") << ")\n";
     
-    // Cleanup
-    treeDestroy(&radix_new_tree);
+    cuAvlTreeDeinitialize(&generic_tree);
+    cuAvlTreeDeinitialize(&u64_tree);
 }
 
-int main() {
-    const size_t num_keys = 100000;
-    const size_t num_searches = 50000;
+// Extracting a contiguous range of page-aligned keys out of a CUavlTree into
+// its own tree and merging it back: per-node remove + insert vs two
+// cuAvlTreeSplit calls and two cuAvlTreeJoin calls
+void benchmark_avl_split_join(size_t num_nodes) {
+    Timer timer;
+    CUavlTree tree;
+    CUavlTreeNodePool pool;
+    std::vector<CUavlTreeNode*> nodes(num_nodes);
+    cuAvlTreeInitializeU64(&tree, [](CUavlTreeKey) {});
+    cuAvlTreeNodePoolInitialize(&pool, 4096);
+    for (size_t i = 0; i < num_nodes; ++i) {
+        nodes[i] = cuAvlTreeNodePoolAlloc(&pool);
+        nodes[i]->key = (CUavlTreeKey)(uintptr_t)(i * 4096);
+        nodes[i]->value = NULL;
+    }
+    cuAvlTreeBuildFromSorted(&tree, nodes.data(), nodes.size());
     
-    std::cout << "Radix Tree vs C++ Standard Library Benchmark\n";
-    std::cout << "=============================================\n";
-    std::cout << "Dataset size: " << num_keys << " keys\n";
-    std::cout << "Search operations: " << num_searches << " lookups\n\n";
+    std::cout << "  " << num_nodes << "-node tree (extract range / merge back, ms):\n";
+    for (size_t range_nodes : {1000, 10000, 100000, 1000000}) {
+        NvU64 first = (num_nodes / 4) * 4096;
+        NvU64 end = first + range_nodes * 4096;
+        
+        CUavlTree moved;
+        cuAvlTreeInitializeU64(&moved, [](CUavlTreeKey) {});
+        timer.start();
+        size_t moved_count = 0;
+        for (CUavlTreeNode* node = cuAvlTreeNodeFindGEQU64(&tree, first); node && cuAvlTreeNodeKeyU64(node) < end;) {
+            CUavlTreeNode* next = cuAvlTreeNodeInOrderSuccessor(&tree, node);
+            cuAvlTreeNodeRemove(&tree, node);
+            cuAvlTreeNodeInsertU64(&moved, node, cuAvlTreeNodeKeyU64(node), node->value);
+            moved_count++;
+            node = next;
+        }
+        double loop_extract_time = timer.stop();
+        timer.start();
+        for (CUavlTreeNode* node = cuAvlTreeNodeFindGEQU64(&moved, 0); node;) {
+            CUavlTreeNode* next = cuAvlTreeNodeInOrderSuccessor(&moved, node);
+            cuAvlTreeNodeRemove(&moved, node);
+            cuAvlTreeNodeInsertU64(&tree, node, cuAvlTreeNodeKeyU64(node), node->value);
+            node = next;
+        }
+        double loop_merge_time = timer.stop();
+        
+        CUavlTree range;
+        CUavlTree upper;
+        timer.start();
+        cuAvlTreeSplit(&tree, (CUavlTreeKey)(uintptr_t)first, &tree, &upper);
+        cuAvlTreeSplit(&upper, (CUavlTreeKey)(uintptr_t)end, &range, &upper);
+        double split_time = timer.stop();
+        CUavlTreeNode* range_first = cuAvlTreeNodeFindGEQU64(&range, 0);
+        CUavlTreeNode* range_last = cuAvlTreeNodeFindLEQU64(&range, ~0ULL);
+        bool range_ok = range_first && range_last && cuAvlTreeNodeKeyU64(range_first) == first &&
+                        cuAvlTreeNodeKeyU64(range_last) == first + (moved_count - 1) * 4096;
+        timer.start();
+        cuAvlTreeJoin(&tree, &range);
+        cuAvlTreeJoin(&tree, &upper);
+        double join_time = timer.stop();
+        
+        std::cout << "    " << std::setw(7) << moved_count << " nodes: per-node " << std::fixed << std::setprecision(3)
+                  << loop_extract_time << " / " << loop_merge_time << ", split/join " << std::setprecision(4)
+                  << split_time << " / " << join_time << " (" << (range_ok ? "ranges match" : "RANGES DIFFER")
+                  << ")\n";
+    }
+    cuAvlTreeAssertValid(&tree);
     
-    // Generate random keys
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<NvU64> dis(1, 1000000);
+    cuAvlTreeDeinitialize(&tree);
+    cuAvlTreeNodePoolDeinitialize(&pool);
+}
+
+// Cost of CU_AVL_TREE_FLAG_COUNTS on inserts and removes, and percentile
+// lookups through cuAvlTreeSelect/cuAvlTreeRank vs in-order walks
+void benchmark_avl_order_statistics(const std::vector<NvU64>& keys) {
+    Timer timer;
     
-    std::vector<NvU64> keys;
-    keys.reserve(num_keys);
-    for (size_t i = 0; i < num_keys; ++i) {
-        keys.push_back(dis(gen));
+    // The count update is a few instructions per node on the rebalance path,
+    // which cache misses on random-order inserts bury in noise. Sorted
+    // inserts and removes keep that path cached, so the timing is dominated
+    // by the rebalance work itself. Best of several rounds, alternating
+    // which variant runs first.
+    std::vector<NvU64> sorted_keys(keys);
+    std::sort(sorted_keys.begin(), sorted_keys.end());
+    sorted_keys.erase(std::unique(sorted_keys.begin(), sorted_keys.end()), sorted_keys.end());
+    const int num_rounds = 5;
+    double insert_time[2];
+    double remove_time[2];
+    std::vector<CUavlTreeNode> nodes[2] = {std::vector<CUavlTreeNode>(keys.size()),
+                                           std::vector<CUavlTreeNode>(keys.size())};
+    CUavlTree trees[2];
+    for (int round = 0; round < num_rounds; ++round) {
+        for (int turn = 0; turn < 2; ++turn) {
+            int counted = (round + turn) & 1;
+            cuAvlTreeInitializeU64WithFlags(&trees[counted], [](CUavlTreeKey) {}, counted ? CU_AVL_TREE_FLAG_COUNTS : 0);
+            timer.start();
+            for (size_t i = 0; i < sorted_keys.size(); ++i) {
+                cuAvlTreeNodeInsertU64(&trees[counted], &nodes[counted][i], sorted_keys[i], NULL);
+            }
+            double insert = timer.stop();
+            timer.start();
+            for (size_t i = 0; i < sorted_keys.size(); ++i) {
+                cuAvlTreeNodeRemove(&trees[counted], &nodes[counted][i]);
+            }
+            double remove = timer.stop();
+            insert_time[counted] = round ? std::min(insert_time[counted], insert) : insert;
+            remove_time[counted] = round ? std::min(remove_time[counted], remove) : remove;
+        }
     }
     
-    // Sort keys but keep duplicates since we're testing duplicate handling
-    std::sort(keys.begin(), keys.end());
+    // Percentile queries run on a counted tree built in random order
+    CUavlTree* tree = &trees[1];
+    std::vector<char> linked(keys.size());
+    cuAvlTreeInitializeU64WithFlags(tree, [](CUavlTreeKey) {}, CU_AVL_TREE_FLAG_COUNTS);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        linked[i] = (cuAvlTreeNodeInsertU64(tree, &nodes[1][i], keys[i], NULL) == CU_AVL_TREE_STATUS_SUCCESS);
+    }
     
-    // Generate search keys (mix of existing and non-existing)
-    std::vector<NvU64> search_keys;
-    search_keys.reserve(num_searches);
+    // Percentiles: the node at a given rank, and the rank of a given key
+    NvU64 count = cuAvlTreeCount(tree);
+    std::mt19937_64 gen(17);
+    std::vector<NvU64> ranks(100000);
+    for (auto& rank : ranks) rank = gen() % count;
+    timer.start();
+    NvU64 select_sum = 0;
+    for (NvU64 rank : ranks) {
+        select_sum += cuAvlTreeNodeKeyU64(cuAvlTreeSelect(tree, rank));
+    }
+    double select_time = timer.stop();
+    timer.start();
+    NvU64 rank_sum = 0;
+    for (NvU64 rank : ranks) {
+        rank_sum += cuAvlTreeRank(tree, (CUavlTreeKey)(uintptr_t)keys[rank]);
+    }
+    double rank_time = timer.stop();
+    
+    // The walk visits rank nodes per query, so it only gets a few
+    const size_t num_walks = 10;
+    timer.start();
+    NvU64 walk_sum = 0;
+    for (size_t q = 0; q < num_walks; ++q) {
+        CUavlTreeNode* node = cuAvlTreeNodeFindGEQU64(tree, 0);
+        for (NvU64 step = 0; step < ranks[q]; ++step) {
+            node = cuAvlTreeNodeInOrderSuccessor(tree, node);
+        }
+        walk_sum += cuAvlTreeNodeKeyU64(node);
+    }
+    double walk_time = timer.stop();
+    NvU64 check_sum = 0;
+    for (size_t q = 0; q < num_walks; ++q) {
+        check_sum += cuAvlTreeNodeKeyU64(cuAvlTreeSelect(tree, ranks[q]));
+    }
+    
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (linked[i]) {
+            cuAvlTreeNodeRemove(tree, &nodes[1][i]);
+        }
+    }
+    
+    std::cout << "  " << sorted_keys.size() << " keys in sorted order, best of " << num_rounds
+              << " rounds (insert / remove, us/op):\n";
+    std::cout << "    Without counts: " << std::fixed << std::setprecision(3) << (insert_time[0] * 1000.0) / sorted_keys.size()
+              << " / " << (remove_time[0] * 1000.0) / sorted_keys.size() << "\n";
+    std::cout << "    With counts:    " << std::fixed << std::setprecision(3) << (insert_time[1] * 1000.0) / sorted_keys.size()
+              << " / " << (remove_time[1] * 1000.0) / sorted_keys.size() << " (" << std::showpos
+              << std::setprecision(1) << (insert_time[1] / insert_time[0] - 1.0) * 100.0 << "% / "
+              << (remove_time[1] / remove_time[0] - 1.0) * 100.0 << std::noshowpos << "%)\n";
+    std::cout << "  Percentile queries over " << count << " nodes (us/op): Select " << std::setprecision(3)
+              << (select_time * 1000.0) / ranks.size() << ", Rank " << (rank_time * 1000.0) / ranks.size()
+              << ", in-order walk " << (walk_time * 1000.0) / num_walks << " ("
+              << (walk_sum == check_sum && select_sum != 0 && rank_sum != 0 ? "results match" : "RESULTS DIFFER")
+              << ")\n";
+    
+    cuAvlTreeDeinitialize(&trees[0]);
+    cuAvlTreeDeinitialize(&trees[1]);
+}
+
+void benchmark_duplicate_keys(const std::vector<NvU64>& dup_keys, const std::vector<NvU64>& search_keys) {
+    Timer timer;
+    
+    // Radix New Tree in multimap mode
+    WideRadixTree multi_tree;
+    treeInitWithFlags(&multi_tree, 64, 8, TREE_FLAG_MULTI);
+    timer.start();
+    for (size_t i = 0; i < dup_keys.size(); ++i) {
+        treeInsertDuplicate(&multi_tree, dup_keys[i], i + 1);
+    }
+    double multi_insert_time = timer.stop();
+    
+    timer.start();
+    size_t multi_found = 0;
+    uint64_t values[64];
+    for (const auto& key : search_keys) {
+        multi_found += treeFindAll(&multi_tree, key, values, 64);
+    }
+    double multi_find_time = timer.stop();
+    
+    timer.start();
+    for (const auto& key : dup_keys) {
+        treeRemove(&multi_tree, key);
+    }
+    double multi_remove_time = timer.stop();
+    treeDestroy(&multi_tree);
+    
+    // CUradixTree keeps duplicates in a per-node circular list
+    CUradixTree radix_tree;
+    std::vector<CUradixNode> nodes(dup_keys.size());
+    radixTreeInit(&radix_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < dup_keys.size(); ++i) {
+        radixTreeInsert(&radix_tree, &nodes[i], dup_keys[i]);
+    }
+    double radix_insert_time = timer.stop();
+    
+    timer.start();
+    size_t radix_found = 0;
+    for (const auto& key : search_keys) {
+        CUradixNode* found = radixTreeFindGEQ(&radix_tree, key);
+        if (found && found->key == key) {
+            CUradixNode* dup = found;
+            do {
+                radix_found++;
+                dup = dup->next;
+            } while (dup != found);
+        }
+    }
+    double radix_find_time = timer.stop();
+    
+    timer.start();
+    for (auto& node : nodes) {
+        radixTreeRemove(&node);
+    }
+    double radix_remove_time = timer.stop();
+    
+    // std::multiset
+    std::multiset<NvU64> multi_set;
+    timer.start();
+    for (const auto& key : dup_keys) {
+        multi_set.insert(key);
+    }
+    double set_insert_time = timer.stop();
+    
+    timer.start();
+    size_t set_found = 0;
+    for (const auto& key : search_keys) {
+        set_found += multi_set.count(key);
+    }
+    double set_find_time = timer.stop();
+    
+    timer.start();
+    for (const auto& key : dup_keys) {
+        multi_set.erase(multi_set.find(key));
+    }
+    double set_remove_time = timer.stop();
+    
+    std::cout << "Duplicate-Heavy Results (insert / find-all / remove-one, us/op):\n";
+    std::cout << "  Radix New Multi: " << std::fixed << std::setprecision(3)
+              << (multi_insert_time * 1000.0) / dup_keys.size() << " / "
+              << (multi_find_time * 1000.0) / search_keys.size() << " / "
+              << (multi_remove_time * 1000.0) / dup_keys.size() << " (" << multi_found << " values found)\n";
+    std::cout << "  Radix Tree:      " << std::fixed << std::setprecision(3)
+              << (radix_insert_time * 1000.0) / dup_keys.size() << " / "
+              << (radix_find_time * 1000.0) / search_keys.size() << " / "
+              << (radix_remove_time * 1000.0) / dup_keys.size() << " (" << radix_found << " values found)\n";
+    std::cout << "  std::multiset:   " << std::fixed << std::setprecision(3)
+              << (set_insert_time * 1000.0) / dup_keys.size() << " / "
+              << (set_find_time * 1000.0) / search_keys.size() << " / "
+              << (set_remove_time * 1000.0) / dup_keys.size() << " (" << set_found << " values found)\n\n";
+}
+
+// Predecessor search and in-order iteration: CUradixTree (heap-ordered, so
+// LEQ needs the largest leaf of a passed-over subtree) vs AVL vs std::set
+void benchmark_predecessor_queries(const std::vector<NvU64>& keys) {
+    Timer timer;
+    
+    CUradixTree radix_tree;
+    std::vector<CUradixNode> radix_nodes(keys.size());
+    radixTreeInit(&radix_tree, 64);
+    
+    auto compare_func = [](CUavlTreeKey a, CUavlTreeKey b) -> int {
+        NvU64 key_a = *(NvU64*)a;
+        NvU64 key_b = *(NvU64*)b;
+        if (key_a < key_b) return -1;
+        if (key_a > key_b) return 1;
+        return 0;
+    };
+    CUavlTree avl_tree;
+    std::vector<CUavlTreeNode> avl_nodes(keys.size());
+    cuAvlTreeInitialize(&avl_tree, compare_func, [](CUavlTreeKey) {});
+    
+    std::multiset<NvU64> std_set;
+    
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&radix_tree, &radix_nodes[i], keys[i]);
+        cuAvlTreeNodeInsert(&avl_tree, &avl_nodes[i], (void*)&keys[i], (void*)&keys[i]);
+        std_set.insert(keys[i]);
+    }
+    
+    // Queries fall between, on and past the stored keys
+    std::vector<NvU64> query_keys;
+    for (size_t i = 0; i < 10000; ++i) {
+        query_keys.push_back(keys[(i * 7919) % keys.size()] + (i % 100) - 50);
+    }
+    
+    timer.start();
+    NvU64 radix_sum = 0;
+    for (const auto& query : query_keys) {
+        CUradixNode* found = radixTreeFindLEQ(&radix_tree, query);
+        if (found) radix_sum += found->key;
+    }
+    double radix_leq_time = timer.stop();
+    
+    timer.start();
+    NvU64 avl_sum = 0;
+    for (const auto& query : query_keys) {
+        CUavlTreeNode* found = cuAvlTreeNodeFindLEQ(&avl_tree, (void*)&query);
+        if (found) avl_sum += *(NvU64*)found->key;
+    }
+    double avl_leq_time = timer.stop();
+    
+    timer.start();
+    NvU64 set_sum = 0;
+    for (const auto& query : query_keys) {
+        auto it = std_set.upper_bound(query);
+        if (it != std_set.begin()) set_sum += *std::prev(it);
+    }
+    double set_leq_time = timer.stop();
+    
+    // Full in-order walks; the radix tree and multiset also visit duplicates
+    timer.start();
+    size_t radix_visited = 0;
+    for (CUradixNode* node = radixTreeFindGEQ(&radix_tree, 0); node; node = radixTreeNext(node)) {
+        radix_visited++;
+    }
+    double radix_iter_time = timer.stop();
+    
+    timer.start();
+    size_t avl_visited = 0;
+    NvU64 zero = 0;
+    for (CUavlTreeNode* node = cuAvlTreeNodeFindGEQ(&avl_tree, &zero); node;
+         node = cuAvlTreeNodeInOrderSuccessor(&avl_tree, node)) {
+        avl_visited++;
+    }
+    double avl_iter_time = timer.stop();
+    
+    timer.start();
+    size_t set_visited = 0;
+    for (auto it = std_set.begin(); it != std_set.end(); ++it) {
+        set_visited++;
+    }
+    double set_iter_time = timer.stop();
+    
+    std::cout << "Predecessor Query Performance (FindLEQ / in-order next):\n";
+    std::cout << "  CUDA Radix Tree: " << std::fixed << std::setprecision(3)
+              << (radix_leq_time * 1000.0) / query_keys.size() << " / "
+              << (radix_iter_time * 1000.0) / radix_visited << " us/op (" << radix_visited << " nodes visited"
+              << (radix_sum == set_sum ? ", matches std::multiset" : ", MISMATCH vs std::multiset") << ")\n";
+    std::cout << "  AVL Tree:        " << std::fixed << std::setprecision(3)
+              << (avl_leq_time * 1000.0) / query_keys.size() << " / "
+              << (avl_iter_time * 1000.0) / avl_visited << " us/op (" << avl_visited << " nodes visited"
+              << (avl_sum == set_sum ? ", matches std::multiset" : ", MISMATCH vs std::multiset") << ")\n";
+    std::cout << "  std::multiset:   " << std::fixed << std::setprecision(3)
+              << (set_leq_time * 1000.0) / query_keys.size() << " / "
+              << (set_iter_time * 1000.0) / set_visited << " us/op (" << set_visited << " nodes visited)\n\n";
+    
+    cuAvlTreeDeinitialize(&avl_tree);
+}
+
+// Best-fit allocator on a CUradixTree of free block sizes: each cycle takes
+// the smallest block >= a random request and frees a random allocated block
+template <bool UseExtract>
+static double run_best_fit_cycles(size_t num_blocks, size_t cycles, size_t* failed) {
+    std::mt19937_64 gen(99);
+    std::vector<CUradixNode> blocks(num_blocks);
+    std::vector<CUradixNode*> allocated;
+    allocated.reserve(num_blocks);
+    CUradixTree tree;
+    radixTreeInit(&tree, 64);
+    
+    // Sizes cluster on 64 page-multiple size classes, so most keys have long duplicate lists
+    for (auto& block : blocks) {
+        radixTreeInsert(&tree, &block, 4096 * (1 + gen() % 64));
+    }
+    
+    Timer timer;
+    timer.start();
+    *failed = 0;
+    for (size_t cycle = 0; cycle < cycles; ++cycle) {
+        NvU64 request = 4096 * (1 + gen() % 64) - gen() % 4096;
+        CUradixNode* node;
+        if (UseExtract) {
+            node = radixTreeExtractGEQ(&tree, request);
+        } else {
+            node = radixTreeFindGEQ(&tree, request);
+            if (node) radixTreeRemove(node);
+        }
+        if (node) {
+            allocated.push_back(node);
+        } else {
+            (*failed)++;
+        }
+        
+        if (!allocated.empty()) {
+            size_t victim = gen() % allocated.size();
+            CUradixNode* freed = allocated[victim];
+            allocated[victim] = allocated.back();
+            allocated.pop_back();
+            radixTreeInsert(&tree, freed, freed->key);
+        }
+    }
+    return timer.stop();
+}
+
+void benchmark_best_fit_allocator(size_t num_blocks, size_t cycles) {
+    size_t find_remove_failed = 0;
+    size_t extract_failed = 0;
+    double find_remove_time = run_best_fit_cycles<false>(num_blocks, cycles, &find_remove_failed);
+    double extract_time = run_best_fit_cycles<true>(num_blocks, cycles, &extract_failed);
+    
+    std::cout << "Best-Fit Allocator Cycles (" << num_blocks << " free blocks, " << cycles << " alloc+free cycles):\n";
+    std::cout << "  FindGEQ + Remove: " << std::fixed << std::setprecision(3)
+              << (find_remove_time * 1000.0) / cycles << " us/cycle (" << find_remove_failed << " failed)\n";
+    std::cout << "  ExtractGEQ:       " << std::fixed << std::setprecision(3)
+              << (extract_time * 1000.0) / cycles << " us/cycle (" << extract_failed << " failed)\n\n";
+}
+
+// The va_allocator policy (best fit in size then insertion order, lowest
+// aligned address, coalescing on free) over std::multimap by size and
+// std::map by address
+class MultimapVaAllocator {
+public:
+    MultimapVaAllocator(NvU64 base, NvU64 size) : free_bytes(size) {
+        if (size) link(base, size);
+    }
+    
+    bool alloc(NvU64 size, NvU64 alignment, NvU64* addr) {
+        for (auto it = by_size.lower_bound(size); it != by_size.end(); ++it) {
+            NvU64 start = it->second;
+            NvU64 length = it->first;
+            NvU64 aligned = (start + alignment - 1) & ~(alignment - 1);
+            if (aligned < start || aligned - start > length - size) continue;
+            
+            NvU64 head = aligned - start;
+            NvU64 tail = start + length - (aligned + size);
+            unlink(by_addr.find(start));
+            if (head) link(start, head);
+            if (tail) link(aligned + size, tail);
+            free_bytes -= size;
+            *addr = aligned;
+            return true;
+        }
+        return false;
+    }
+    
+    void free(NvU64 addr, NvU64 size) {
+        NvU64 start = addr;
+        NvU64 length = size;
+        auto next = by_addr.lower_bound(addr);
+        if (next != by_addr.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second.first == addr) {
+                start = prev->first;
+                length += prev->second.first;
+                unlink(prev);
+            }
+        }
+        if (next != by_addr.end() && next->first == addr + size) {
+            length += next->second.first;
+            unlink(next);
+        }
+        link(start, length);
+        free_bytes += size;
+    }
+    
+    size_t num_free_ranges() const { return by_addr.size(); }
+    NvU64 largest_free() const { return by_size.empty() ? 0 : by_size.rbegin()->first; }
+    NvU64 free_bytes;
+    
+private:
+    typedef std::multimap<NvU64, NvU64> SizeIndex;
+    // start -> (length, the range's entry in by_size)
+    typedef std::map<NvU64, std::pair<NvU64, SizeIndex::iterator>> AddrIndex;
+    
+    void link(NvU64 start, NvU64 length) {
+        by_addr.emplace(start, std::make_pair(length, by_size.emplace(length, start)));
+    }
+    
+    void unlink(AddrIndex::iterator it) {
+        by_size.erase(it->second.second);
+        by_addr.erase(it);
+    }
+    
+    SizeIndex by_size;
+    AddrIndex by_addr;
+};
+
+struct VaTraceOp {
+    bool alloc;
+    NvU64 size;
+    NvU64 alignment;
+    size_t id;  // Allocation this op makes or frees
+};
+
+// Alloc/free trace with page-granular sizes from 4 KB to 2 MB (skewed small)
+// and 4 KB/64 KB/2 MB alignments: grows to num_live allocations, then frees
+// a random live one or allocates with equal probability
+static std::vector<VaTraceOp> make_va_trace(size_t num_live, size_t num_ops, size_t* num_ids) {
+    std::mt19937_64 gen(2024);
+    std::vector<VaTraceOp> trace;
+    std::vector<size_t> live;
+    size_t next_id = 0;
+    trace.reserve(num_live + num_ops);
+    
+    auto push_alloc = [&]() {
+        unsigned shift = 12 + (unsigned)(gen() % 10);
+        NvU64 size = ((gen() % (1ULL << (shift - 12))) + 1) << 12;
+        NvU64 alignment = (size >= (2ULL << 20)) ? (2ULL << 20) : (size >= (64ULL << 10)) ? (64ULL << 10) : 4096;
+        trace.push_back({true, size, alignment, next_id});
+        live.push_back(next_id++);
+    };
+    
+    for (size_t i = 0; i < num_live; ++i) {
+        push_alloc();
+    }
+    for (size_t i = 0; i < num_ops; ++i) {
+        if ((gen() & 1) && !live.empty()) {
+            size_t index = gen() % live.size();
+            trace.push_back({false, 0, 0, live[index]});
+            live[index] = live.back();
+            live.pop_back();
+        } else {
+            push_alloc();
+        }
+    }
+    *num_ids = next_id;
+    return trace;
+}
+
+// Replays make_va_trace on va_allocator and on MultimapVaAllocator; frees of
+// allocations that failed are skipped
+void benchmark_va_allocator(size_t num_live, size_t num_ops) {
+    const NvU64 base = 1ULL << 40;
+    const NvU64 size = 1ULL << 38;  // 256 GB, about ten times the live set
+    size_t num_ids;
+    std::vector<VaTraceOp> trace = make_va_trace(num_live, num_ops, &num_ids);
+    std::vector<NvU64> alloc_size(num_ids);
+    for (const auto& op : trace) {
+        if (op.alloc) alloc_size[op.id] = op.size;
+    }
+    Timer timer;
+    
+    std::vector<NvU64> radix_addr(num_ids, ~0ULL);
+    size_t radix_failed = 0;
+    CUvaAllocator va;
+    if (vaAllocatorInit(&va, base, size) != 0) {
+        std::cout << "  va_allocator: initialization failed\n";
+        return;
+    }
+    timer.start();
+    for (const auto& op : trace) {
+        if (op.alloc) {
+            if (vaAllocatorAlloc(&va, op.size, op.alignment, &radix_addr[op.id]) != 0) {
+                radix_addr[op.id] = ~0ULL;
+                radix_failed++;
+            }
+        } else if (radix_addr[op.id] != ~0ULL) {
+            vaAllocatorFree(&va, radix_addr[op.id], alloc_size[op.id]);
+        }
+    }
+    double radix_time = timer.stop();
+    NvU64 radix_ranges = va.num_free_ranges;
+    double radix_frag = va.free_bytes ? 1.0 - (double)vaAllocatorLargestFree(&va) / va.free_bytes : 0.0;
+    vaAllocatorDestroy(&va);
+    
+    std::vector<NvU64> map_addr(num_ids, ~0ULL);
+    size_t map_failed = 0;
+    MultimapVaAllocator map_va(base, size);
+    timer.start();
+    for (const auto& op : trace) {
+        if (op.alloc) {
+            if (!map_va.alloc(op.size, op.alignment, &map_addr[op.id])) {
+                map_addr[op.id] = ~0ULL;
+                map_failed++;
+            }
+        } else if (map_addr[op.id] != ~0ULL) {
+            map_va.free(map_addr[op.id], alloc_size[op.id]);
+        }
+    }
+    double map_time = timer.stop();
+    double map_frag = map_va.free_bytes ? 1.0 - (double)map_va.largest_free() / map_va.free_bytes : 0.0;
+    
+    std::cout << "VA Range Allocator (" << trace.size() << " trace ops, " << num_live
+              << " live allocations; fragmentation = 1 - largest free / free):\n";
+    std::cout << "  CUradixTree indexes:   " << std::fixed << std::setprecision(3)
+              << (radix_time * 1000.0) / trace.size() << " us/op, " << radix_ranges << " free ranges, "
+              << std::setprecision(4) << radix_frag << " fragmentation, " << radix_failed << " failed\n";
+    std::cout << "  std::multimap/map:     " << std::fixed << std::setprecision(3)
+              << (map_time * 1000.0) / trace.size() << " us/op, " << map_va.num_free_ranges() << " free ranges, "
+              << std::setprecision(4) << map_frag << " fragmentation, " << map_failed << " failed ("
+              << (radix_addr == map_addr ? "same addresses" : "ADDRESSES DIFFER") << ")\n\n";
+}
+
+// Remove every distinct key in random order after building each structure
+void benchmark_removal(const std::vector<NvU64>& keys) {
+    Timer timer;
+    std::vector<NvU64> unique_keys(keys);
+    std::sort(unique_keys.begin(), unique_keys.end());
+    unique_keys.erase(std::unique(unique_keys.begin(), unique_keys.end()), unique_keys.end());
+    std::vector<size_t> remove_index(unique_keys.size());
+    for (size_t i = 0; i < remove_index.size(); ++i) {
+        remove_index[i] = i;
+    }
+    std::shuffle(remove_index.begin(), remove_index.end(), std::mt19937_64(7));
+    std::vector<NvU64> remove_order;
+    remove_order.reserve(remove_index.size());
+    for (size_t index : remove_index) {
+        remove_order.push_back(unique_keys[index]);
+    }
+    const double num_removes = remove_order.size();
+    
+    // Intrusive trees: nodes are indexed by the key's position in unique_keys
+    CUradixTree radix_tree;
+    std::vector<CUradixNode> radix_nodes(unique_keys.size());
+    radixTreeInit(&radix_tree, 64);
+    for (size_t i = 0; i < unique_keys.size(); ++i) {
+        radixTreeInsert(&radix_tree, &radix_nodes[i], unique_keys[i]);
+    }
+    timer.start();
+    for (size_t index : remove_index) {
+        radixTreeRemove(&radix_nodes[index]);
+    }
+    double radix_time = timer.stop();
+    bool radix_empty = radixTreeEmpty(&radix_tree);
+    
+    wide_radix_tree_t wide_radix_tree;
+    wide_radix_init(&wide_radix_tree, 64);
+    for (const auto& key : unique_keys) {
+        wide_radix_insert(&wide_radix_tree, key, key);
+    }
+    timer.start();
+    for (const auto& key : remove_order) {
+        wide_radix_delete(&wide_radix_tree, key);
+    }
+    double wide_radix_time = timer.stop();
+    bool wide_radix_is_empty = wide_radix_empty(&wide_radix_tree);
+    wide_radix_destroy(&wide_radix_tree);
+    
+    WideRadixTree radix_new_tree;
+    treeInit(&radix_new_tree, 64, 8);
+    for (const auto& key : unique_keys) {
+        uint64_t existing;
+        treeInsertOrReturnExisting(&radix_new_tree, key, key, &existing);
+    }
+    timer.start();
+    for (const auto& key : remove_order) {
+        treeRemove(&radix_new_tree, key);
+    }
+    double radix_new_time = timer.stop();
+    bool radix_new_empty = (treeFindGEQ(&radix_new_tree, 0) == 0);  // Values are the keys, all non-zero
+    treeDestroy(&radix_new_tree);
+    
+    art_tree art;
+    art_tree_init(&art);
+    auto to_bytes = [](NvU64 key, unsigned char* key_bytes) {
+        for (int i = 0; i < 8; i++) {
+            key_bytes[7-i] = (key >> (i * 8)) & 0xFF;  // Big-endian for lexicographic order
+        }
+    };
+    for (const auto& key : unique_keys) {
+        unsigned char key_bytes[8];
+        to_bytes(key, key_bytes);
+        art_insert(&art, key_bytes, 8, (void*)1);
+    }
+    timer.start();
+    for (const auto& key : remove_order) {
+        unsigned char key_bytes[8];
+        to_bytes(key, key_bytes);
+        art_delete(&art, key_bytes, 8);
+    }
+    double art_time = timer.stop();
+    bool art_empty = (art_size(&art) == 0);
+    art_tree_destroy(&art);
+    
+    auto compare_func = [](CUavlTreeKey a, CUavlTreeKey b) -> int {
+        NvU64 key_a = *(NvU64*)a;
+        NvU64 key_b = *(NvU64*)b;
+        if (key_a < key_b) return -1;
+        if (key_a > key_b) return 1;
+        return 0;
+    };
+    CUavlTree avl_tree;
+    std::vector<CUavlTreeNode> avl_nodes(unique_keys.size());
+    cuAvlTreeInitialize(&avl_tree, compare_func, [](CUavlTreeKey) {});
+    for (size_t i = 0; i < unique_keys.size(); ++i) {
+        cuAvlTreeNodeInsert(&avl_tree, &avl_nodes[i], (void*)&unique_keys[i], (void*)&unique_keys[i]);
+    }
+    timer.start();
+    for (size_t index : remove_index) {
+        cuAvlTreeNodeRemove(&avl_tree, &avl_nodes[index]);
+    }
+    double avl_time = timer.stop();
+    bool avl_empty = (avl_tree.root == NULL);
+    cuAvlTreeDeinitialize(&avl_tree);
+    
+    std::set<NvU64> std_set(unique_keys.begin(), unique_keys.end());
+    timer.start();
+    for (const auto& key : remove_order) {
+        std_set.erase(key);
+    }
+    double set_time = timer.stop();
+    
+    auto report = [&](const char* name, double time, bool emptied) {
+        std::cout << "  " << name << std::fixed << std::setprecision(3) << (time * 1000.0) / num_removes << " us/op"
+                  << (emptied ? "" : " (NOT EMPTY AFTER REMOVAL)") << "\n";
+    };
+    std::cout << "Removal Performance (" << remove_order.size() << " distinct keys, random order):\n";
+    report("CUDA Radix Tree: ", radix_time, radix_empty);
+    report("Wide Radix Tree: ", wide_radix_time, wide_radix_is_empty);
+    report("Radix New Tree:  ", radix_new_time, radix_new_empty);
+    report("libart:          ", art_time, art_empty);
+    report("AVL Tree:        ", avl_time, avl_empty);
+    report("std::set:        ", set_time, std_set.empty());
+    std::cout << "\n";
+}
+
+// AVL-based interval tree on CUavlTree for comparison: the start is the AVL
+// key and every node tracks the largest end in its subtree. avl.c has no
+// hooks, so max_end is refreshed after each insert along the path from the
+// new node to the root. Rotations only move nodes on that path or make them
+// children of path nodes, so recomputing each path node's children before
+// the node itself covers every subtree that changed.
+struct AvlInterval {
+    CUavlTreeNode avl;  // First member, so tree nodes convert back
+    NvU64 start;
+    NvU64 end;
+    NvU64 max_end;
+};
+
+static inline AvlInterval* avl_interval(CUavlTreeNode* node) {
+    return reinterpret_cast<AvlInterval*>(node);
+}
+
+static void avl_interval_update(CUavlTreeNode* node) {
+    if (!node) return;
+    AvlInterval* interval = avl_interval(node);
+    interval->max_end = interval->end;
+    if (node->left) interval->max_end = std::max(interval->max_end, avl_interval(node->left)->max_end);
+    if (node->right) interval->max_end = std::max(interval->max_end, avl_interval(node->right)->max_end);
+}
+
+static void avl_interval_insert(CUavlTree* tree, AvlInterval* interval, NvU64 start, NvU64 length) {
+    interval->start = start;
+    interval->end = start + length;
+    interval->max_end = interval->end;
+    cuAvlTreeNodeInsert(tree, &interval->avl, &interval->start, interval);
+    for (CUavlTreeNode* node = &interval->avl; node; node = node->parent) {
+        avl_interval_update(node->left);
+        avl_interval_update(node->right);
+        avl_interval_update(node);
+    }
+}
+
+// Lowest-start interval overlapping [first, last]
+static AvlInterval* avl_interval_find_first(CUavlTree* tree, NvU64 first, NvU64 last) {
+    CUavlTreeNode* node = tree->root;
+    while (node) {
+        AvlInterval* interval = avl_interval(node);
+        if (node->left && avl_interval(node->left)->max_end > first) {
+            node = node->left;
+            continue;
+        }
+        if (interval->start > last) return nullptr;
+        if (interval->end > first) return interval;
+        node = node->right;
+    }
+    return nullptr;
+}
+
+void benchmark_interval_queries(size_t num_intervals) {
+    Timer timer;
+    std::mt19937_64 gen(2024);
+    
+    // VA-style allocations: distinct page-aligned starts over a 64 GB range,
+    // lengths of 1-256 pages, so neighbouring allocations sometimes overlap
+    std::set<NvU64> start_set;
+    while (start_set.size() < num_intervals) {
+        start_set.insert((gen() % (1ULL << 24)) << 12);
+    }
+    std::vector<NvU64> starts(start_set.begin(), start_set.end());
+    std::shuffle(starts.begin(), starts.end(), gen);
+    std::vector<NvU64> lengths(num_intervals);
+    for (auto& length : lengths) {
+        length = (1 + gen() % 256) << 12;
+    }
+    
+    std::vector<NvU64> stab_queries(100000);
+    for (auto& query : stab_queries) {
+        query = gen() % (1ULL << 36);
+    }
+    
+    CUradixIntervalTree radix_tree;
+    std::vector<CUradixIntervalNode> radix_nodes(num_intervals);
+    radixIntervalTreeInit(&radix_tree, 36);  // Starts are below 64 GB; unused top bits only add depth
+    timer.start();
+    for (size_t i = 0; i < num_intervals; ++i) {
+        radixIntervalTreeInsert(&radix_tree, &radix_nodes[i], starts[i], lengths[i]);
+    }
+    double radix_insert_time = timer.stop();
+    
+    auto compare_func = [](CUavlTreeKey a, CUavlTreeKey b) -> int {
+        NvU64 key_a = *(NvU64*)a;
+        NvU64 key_b = *(NvU64*)b;
+        if (key_a < key_b) return -1;
+        if (key_a > key_b) return 1;
+        return 0;
+    };
+    CUavlTree avl_tree;
+    std::vector<AvlInterval> avl_nodes(num_intervals);
+    cuAvlTreeInitialize(&avl_tree, compare_func, [](CUavlTreeKey) {});
+    timer.start();
+    for (size_t i = 0; i < num_intervals; ++i) {
+        avl_interval_insert(&avl_tree, &avl_nodes[i], starts[i], lengths[i]);
+    }
+    double avl_insert_time = timer.stop();
+    
+    // Stabbing queries (which allocation contains this address)
+    timer.start();
+    NvU64 radix_stab_sum = 0;
+    for (const auto& query : stab_queries) {
+        CUradixIntervalNode* found = radixIntervalTreeFindContaining(&radix_tree, query);
+        if (found) radix_stab_sum += found->start;
+    }
+    double radix_stab_time = timer.stop();
+    
+    timer.start();
+    NvU64 avl_stab_sum = 0;
+    for (const auto& query : stab_queries) {
+        AvlInterval* found = avl_interval_find_first(&avl_tree, query, query);
+        if (found) avl_stab_sum += found->start;
+    }
+    double avl_stab_time = timer.stop();
+    
+    // Overlap queries with 64 KB ranges
+    const NvU64 range = 1ULL << 16;
+    timer.start();
+    NvU64 radix_overlap_sum = 0;
+    for (const auto& query : stab_queries) {
+        CUradixIntervalNode* found = radixIntervalTreeFindOverlap(&radix_tree, query, range);
+        if (found) radix_overlap_sum += found->start;
+    }
+    double radix_overlap_time = timer.stop();
+    
+    timer.start();
+    NvU64 avl_overlap_sum = 0;
+    for (const auto& query : stab_queries) {
+        AvlInterval* found = avl_interval_find_first(&avl_tree, query, query + range - 1);
+        if (found) avl_overlap_sum += found->start;
+    }
+    double avl_overlap_time = timer.stop();
+    
+    std::cout << "Interval Queries (" << num_intervals << " intervals; insert / stab / overlap):\n";
+    std::cout << "  Radix Interval Tree: " << std::fixed << std::setprecision(3)
+              << (radix_insert_time * 1000.0) / num_intervals << " / "
+              << (radix_stab_time * 1000.0) / stab_queries.size() << " / "
+              << (radix_overlap_time * 1000.0) / stab_queries.size() << " us/op\n";
+    std::cout << "  AVL Interval Tree:   " << std::fixed << std::setprecision(3)
+              << (avl_insert_time * 1000.0) / num_intervals << " / "
+              << (avl_stab_time * 1000.0) / stab_queries.size() << " / "
+              << (avl_overlap_time * 1000.0) / stab_queries.size() << " us/op ("
+              << (radix_stab_sum == avl_stab_sum && radix_overlap_sum == avl_overlap_sum ? "results match"
+                                                                                        : "RESULTS DIFFER")
+              << ")\n\n";
+    
+    cuAvlTreeDeinitialize(&avl_tree);
+}
+
+// FindGEQ on the pointer-based CUradixNode layout vs the compact hot/cold
+// layout with 32-bit handles, on trees of random 64-bit keys. The trees are
+// built one after the other so that only one is resident at a time.
+void benchmark_compact_layout(size_t num_nodes) {
+    Timer timer;
+    const size_t num_queries = 1000000;
+    std::vector<NvU64> queries(num_queries);
+    std::mt19937_64 query_gen(num_nodes + 1);
+    for (auto& query : queries) {
+        query = query_gen();
+    }
+    
+    std::cout << "  " << std::setw(9) << num_nodes << " nodes:\n";
+    
+    double radix_geq_time;
+    NvU64 radix_sum = 0;
+    {
+        CUradixTree tree;
+        std::vector<CUradixNode> nodes(num_nodes);
+        std::mt19937_64 gen(num_nodes);
+        radixTreeInit(&tree, 64);
+        for (auto& node : nodes) {
+            radixTreeInsert(&tree, &node, gen());
+        }
+        timer.start();
+        for (const auto& query : queries) {
+            CUradixNode* found = radixTreeFindGEQ(&tree, query);
+            if (found) radix_sum += found->key;
+        }
+        radix_geq_time = timer.stop();
+    }
+    std::cout << "    CUradixNode (" << sizeof(CUradixNode) << " B/node):      " << std::fixed << std::setprecision(3)
+              << (radix_geq_time * 1000.0) / num_queries << " us/op\n";
+    
+    CUradixCompactTree compact;
+    if (radixCompactTreeInit(&compact, 64, (NvU32)num_nodes + 1) != 0) {
+        std::cout << "    Compact: allocation failed\n";
+        return;
+    }
+    std::mt19937_64 gen(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+        radixCompactTreeInsert(&compact, gen());
+    }
+    timer.start();
+    NvU64 compact_sum = 0;
+    for (const auto& query : queries) {
+        CUradixCompactHandle found = radixCompactTreeFindGEQ(&compact, query);
+        if (found != RADIX_COMPACT_NULL) compact_sum += radixCompactTreeKey(&compact, found);
+    }
+    double compact_geq_time = timer.stop();
+    radixCompactTreeDestroy(&compact);
+    
+    std::cout << "    Compact (" << sizeof(CUradixCompactHot) << "+" << sizeof(CUradixCompactCold) << " B/node):      "
+              << std::fixed << std::setprecision(3) << (compact_geq_time * 1000.0) / num_queries << " us/op ("
+              << (radix_sum == compact_sum ? "results match" : "RESULTS DIFFER") << ")\n";
+}
+
+// Average and maximum depth of the primary nodes of an intrusive radix tree
+template <typename Node>
+static void radix_node_depths(const std::vector<Node>& nodes, double* avg_depth, size_t* max_depth) {
+    size_t total = 0;
+    size_t count = 0;
+    *max_depth = 0;
+    for (const auto& node : nodes) {
+        if (!node.parent_to_self_ptr) continue;  // Duplicate list member
+        size_t depth = 1;
+        for (const Node* p = node.parent; p; p = p->parent) {
+            depth++;
+        }
+        total += depth;
+        count++;
+        *max_depth = std::max(*max_depth, depth);
+    }
+    *avg_depth = count ? (double)total / count : 0.0;
+}
+
+// Binary CUradixTree vs the multi-bit stride variant: depth, insert and FindGEQ
+void benchmark_stride_radix(const char* name, const std::vector<NvU64>& keys, const std::vector<NvU64>& queries) {
+    Timer timer;
+    
+    CUradixTree binary_tree;
+    std::vector<CUradixNode> binary_nodes(keys.size());
+    radixTreeInit(&binary_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&binary_tree, &binary_nodes[i], keys[i]);
+    }
+    double binary_insert_time = timer.stop();
+    timer.start();
+    NvU64 binary_sum = 0;
+    for (const auto& query : queries) {
+        CUradixNode* found = radixTreeFindGEQ(&binary_tree, query);
+        if (found) binary_sum += found->key;
+    }
+    double binary_geq_time = timer.stop();
+    
+    CUradixStrideTree stride_tree;
+    std::vector<CUradixStrideNode> stride_nodes(keys.size());
+    radixStrideTreeInit(&stride_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixStrideTreeInsert(&stride_tree, &stride_nodes[i], keys[i]);
+    }
+    double stride_insert_time = timer.stop();
+    timer.start();
+    NvU64 stride_sum = 0;
+    for (const auto& query : queries) {
+        CUradixStrideNode* found = radixStrideTreeFindGEQ(&stride_tree, query);
+        if (found) stride_sum += found->key;
+    }
+    double stride_geq_time = timer.stop();
+    
+    double binary_avg, stride_avg;
+    size_t binary_max, stride_max;
+    radix_node_depths(binary_nodes, &binary_avg, &binary_max);
+    radix_node_depths(stride_nodes, &stride_avg, &stride_max);
+    
+    std::cout << "  " << name << " (" << keys.size() << " keys; depth avg/max, insert / FindGEQ):\n";
+    std::cout << "    Binary:  " << std::fixed << std::setprecision(1) << binary_avg << "/" << binary_max << ", "
+              << std::setprecision(3) << (binary_insert_time * 1000.0) / keys.size() << " / "
+              << (binary_geq_time * 1000.0) / queries.size() << " us/op\n";
+    std::cout << "    " << std::setw(2) << RADIX_STRIDE_FANOUT << "-way:  " << std::fixed << std::setprecision(1)
+              << stride_avg << "/" << stride_max << ", " << std::setprecision(3)
+              << (stride_insert_time * 1000.0) / keys.size() << " / " << (stride_geq_time * 1000.0) / queries.size()
+              << " us/op (" << (binary_sum == stride_sum ? "results match" : "RESULTS DIFFER") << ")\n";
+}
+
+enum ConcurrentMode { CONCURRENT_MUTEX, CONCURRENT_RWLOCK, CONCURRENT_SEQLOCK };
+
+// Readers run FindGEQ for duration_ms while one writer keeps removing a
+// random node and reinserting it under a new key. Returns reader and writer
+// ops/ms; sum collects the found keys so the reads can't be optimized away.
+static void run_concurrent_radix(ConcurrentMode mode, const std::vector<NvU64>& keys, int num_readers,
+                                 double duration_ms, double* read_rate, double* write_rate, NvU64* sum) {
+    CUradixConcurrentTree tree;  // The seqlock wrapper; the other modes use only tree.tree
+    std::mutex mutex;
+    std::shared_mutex rwlock;
+    std::vector<CUradixNode> nodes(keys.size());
+    std::atomic<bool> stop(false);
+    std::vector<NvU64> reads(num_readers, 0);
+    std::vector<NvU64> read_sums(num_readers, 0);
+    NvU64 writes = 0;
+    
+    radixConcurrentTreeInit(&tree, 64);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&tree.tree, &nodes[i], keys[i]);
+    }
+    
+    auto find = [&](NvU64 query) -> NvU64 {
+        NvU64 found_key = 0;
+        if (mode == CONCURRENT_SEQLOCK) {
+            radixConcurrentTreeFindGEQ(&tree, query, &found_key);
+        }
+        else if (mode == CONCURRENT_RWLOCK) {
+            std::shared_lock<std::shared_mutex> lock(rwlock);
+            CUradixNode* found = radixTreeFindGEQ(&tree.tree, query);
+            if (found) found_key = found->key;
+        }
+        else {
+            std::lock_guard<std::mutex> lock(mutex);
+            CUradixNode* found = radixTreeFindGEQ(&tree.tree, query);
+            if (found) found_key = found->key;
+        }
+        return found_key;
+    };
+    
+    std::vector<std::thread> readers;
+    Timer timer;
+    timer.start();
+    for (int r = 0; r < num_readers; ++r) {
+        readers.emplace_back([&, r]() {
+            std::mt19937_64 gen(100 + r);
+            NvU64 count = 0;
+            NvU64 local_sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                local_sum += find(gen());
+                count++;
+            }
+            reads[r] = count;
+            read_sums[r] = local_sum;
+        });
+    }
+    std::thread writer([&]() {
+        std::mt19937_64 gen(99);
+        while (!stop.load(std::memory_order_relaxed)) {
+            CUradixNode* node = &nodes[gen() % nodes.size()];
+            NvU64 key = gen();
+            if (mode == CONCURRENT_SEQLOCK) {
+                radixConcurrentTreeRemove(&tree, node);
+                radixConcurrentTreeInsert(&tree, node, key);
+            }
+            else if (mode == CONCURRENT_RWLOCK) {
+                std::unique_lock<std::shared_mutex> lock(rwlock);
+                radixTreeRemove(node);
+                radixTreeInsert(&tree.tree, node, key);
+            }
+            else {
+                std::lock_guard<std::mutex> lock(mutex);
+                radixTreeRemove(node);
+                radixTreeInsert(&tree.tree, node, key);
+            }
+            writes += 2;
+        }
+    });
+    
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(duration_ms));
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    writer.join();
+    double elapsed = timer.stop();
+    radixConcurrentTreeDestroy(&tree);
+    
+    NvU64 total_reads = 0;
+    *sum = 0;
+    for (int r = 0; r < num_readers; ++r) {
+        total_reads += reads[r];
+        *sum += read_sums[r];
+    }
+    *read_rate = total_reads / elapsed;
+    *write_rate = writes / elapsed;
+}
+
+// Read throughput of CUradixTree under one churning writer: a global mutex,
+// a reader-writer lock, and the optimistic seqlock readers of radix_concurrent
+void benchmark_concurrent_radix(const std::vector<NvU64>& keys, int num_readers) {
+    static const char* names[] = {"Mutex:  ", "RWLock: ", "Seqlock:"};
+    const double duration_ms = 250.0;
+    
+    std::cout << "  " << num_readers << " reader(s) + 1 writer (reads / writes, Mops/s):\n";
+    for (int mode = CONCURRENT_MUTEX; mode <= CONCURRENT_SEQLOCK; ++mode) {
+        double read_rate, write_rate;
+        NvU64 sum;
+        run_concurrent_radix((ConcurrentMode)mode, keys, num_readers, duration_ms, &read_rate, &write_rate, &sum);
+        std::cout << "    " << names[mode] << " " << std::fixed << std::setprecision(3)
+                  << read_rate / 1000.0 << " / " << write_rate / 1000.0 << "\n";
+    }
+}
+
+// Nodes a radix.c GEQ descent (or insert) starting at node examines
+static size_t radix_descent_visits(const CUradixNode* node, NvU64 key) {
+    size_t visits = 0;
+    while (node) {
+        visits++;
+        if (node->key == key) break;
+        node = node->child[(key >> (node->cur_key_bit - 1)) & 1];
+    }
+    return visits;
+}
+
+// Where radixTreeInsertNear/FindGEQFrom start for hint and key, and the
+// parent hops it takes to get there
+static const CUradixNode* radix_hint_start(const CUradixNode* hint, NvU64 key, size_t* hops) {
+    while (!hint->parent_to_self_ptr) hint = hint->next;
+    *hops = 0;
+    while (hint->parent && (((hint->key ^ key) >> hint->cur_key_bit) != 0 || hint->parent->key >= key)) {
+        hint = hint->parent;
+        (*hops)++;
+    }
+    return hint;
+}
+
+// Allocation-like sequential workload: each key is a little above the
+// previous one. Root-started insert and FindGEQ vs the hinted variants with
+// the previous node as the hint.
+void benchmark_hinted_radix(size_t num_keys) {
+    Timer timer;
+    std::mt19937_64 gen(31);
+    std::vector<NvU64> keys(num_keys);
+    NvU64 key = 1ULL << 40;
+    for (auto& k : keys) {
+        key += 1 + (gen() & 0xFFFF);
+        k = key;
+    }
+    
+    CUradixTree root_tree;
+    std::vector<CUradixNode> root_nodes(num_keys);
+    radixTreeInit(&root_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < num_keys; ++i) {
+        radixTreeInsert(&root_tree, &root_nodes[i], keys[i]);
+    }
+    double root_insert_time = timer.stop();
+    timer.start();
+    NvU64 root_sum = 0;
+    for (size_t i = 0; i < num_keys; ++i) {
+        CUradixNode* found = radixTreeFindGEQ(&root_tree, keys[i] - 1);
+        if (found) root_sum += found->key;
+    }
+    double root_geq_time = timer.stop();
+    
+    CUradixTree hint_tree;
+    std::vector<CUradixNode> hint_nodes(num_keys);
+    radixTreeInit(&hint_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < num_keys; ++i) {
+        radixTreeInsertNear(&hint_tree, i ? &hint_nodes[i - 1] : NULL, &hint_nodes[i], keys[i]);
+    }
+    double hint_insert_time = timer.stop();
+    timer.start();
+    NvU64 hint_sum = 0;
+    CUradixNode* hint = radixTreeFindGEQ(&hint_tree, 0);
+    for (size_t i = 0; i < num_keys; ++i) {
+        CUradixNode* found = radixTreeFindGEQFrom(hint, keys[i] - 1);
+        if (found) {
+            hint_sum += found->key;
+            hint = found;
+        }
+    }
+    double hint_geq_time = timer.stop();
+    
+    // Replay the inserts and the queries untimed, counting visited nodes
+    CUradixTree count_tree;
+    std::vector<CUradixNode> count_nodes(num_keys);
+    size_t root_insert_visits = 0, hint_insert_visits = 0;
+    size_t root_geq_visits = 0, hint_geq_visits = 0;
+    radixTreeInit(&count_tree, 64);
+    for (size_t i = 0; i < num_keys; ++i) {
+        root_insert_visits += radix_descent_visits(count_tree.root, keys[i]);
+        if (i) {
+            size_t hops;
+            const CUradixNode* start = radix_hint_start(&count_nodes[i - 1], keys[i], &hops);
+            hint_insert_visits += hops + radix_descent_visits(start, keys[i]);
+        }
+        radixTreeInsert(&count_tree, &count_nodes[i], keys[i]);
+    }
+    hint = radixTreeFindGEQ(&count_tree, 0);
+    for (size_t i = 0; i < num_keys; ++i) {
+        size_t hops;
+        const CUradixNode* start = radix_hint_start(hint, keys[i] - 1, &hops);
+        root_geq_visits += radix_descent_visits(count_tree.root, keys[i] - 1);
+        hint_geq_visits += hops + radix_descent_visits(start, keys[i] - 1);
+        hint = radixTreeFindGEQ(&count_tree, keys[i] - 1);
+    }
+    
+    std::cout << "  " << num_keys << " ascending keys (insert / FindGEQ, avg nodes visited):\n";
+    std::cout << "    From root:   " << std::fixed << std::setprecision(3) << (root_insert_time * 1000.0) / num_keys
+              << " / " << (root_geq_time * 1000.0) / num_keys << " us/op, " << std::setprecision(1)
+              << (double)root_insert_visits / num_keys << " / " << (double)root_geq_visits / num_keys << " nodes\n";
+    std::cout << "    From hint:   " << std::fixed << std::setprecision(3) << (hint_insert_time * 1000.0) / num_keys
+              << " / " << (hint_geq_time * 1000.0) / num_keys << " us/op, " << std::setprecision(1)
+              << (double)hint_insert_visits / num_keys << " / " << (double)hint_geq_visits / num_keys << " nodes ("
+              << (root_sum == hint_sum ? "results match" : "RESULTS DIFFER") << ")\n";
+}
+
+// Heap-ordered CUradixTree vs the leaf-only crit-bit tree: insert, FindGEQ
+// and remove (in shuffled order) over the same keys
+void benchmark_critbit_radix(const char* name, const std::vector<NvU64>& keys, const std::vector<NvU64>& queries) {
+    Timer timer;
+    std::vector<size_t> remove_index(keys.size());
+    for (size_t i = 0; i < remove_index.size(); ++i) {
+        remove_index[i] = i;
+    }
+    std::shuffle(remove_index.begin(), remove_index.end(), std::mt19937_64(3));
+    
+    CUradixTree radix_tree;
+    std::vector<CUradixNode> radix_nodes(keys.size());
+    radixTreeInit(&radix_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&radix_tree, &radix_nodes[i], keys[i]);
+    }
+    double radix_insert_time = timer.stop();
+    timer.start();
+    NvU64 radix_sum = 0;
+    for (const auto& query : queries) {
+        CUradixNode* found = radixTreeFindGEQ(&radix_tree, query);
+        if (found) radix_sum += found->key;
+    }
+    double radix_geq_time = timer.stop();
+    timer.start();
+    for (size_t index : remove_index) {
+        radixTreeRemove(&radix_nodes[index]);
+    }
+    double radix_remove_time = timer.stop();
+    
+    CUradixCritbitTree critbit_tree;
+    std::vector<CUradixCritbitNode> critbit_nodes(keys.size());
+    radixCritbitTreeInit(&critbit_tree, 64);
+    timer.start();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixCritbitTreeInsert(&critbit_tree, &critbit_nodes[i], keys[i]);
+    }
+    double critbit_insert_time = timer.stop();
+    timer.start();
+    NvU64 critbit_sum = 0;
+    for (const auto& query : queries) {
+        CUradixCritbitNode* found = radixCritbitTreeFindGEQ(&critbit_tree, query);
+        if (found) critbit_sum += found->key;
+    }
+    double critbit_geq_time = timer.stop();
+    timer.start();
+    for (size_t index : remove_index) {
+        radixCritbitTreeRemove(&critbit_nodes[index]);
+    }
+    double critbit_remove_time = timer.stop();
+    
+    std::cout << "  " << name << " (" << keys.size() << " keys; insert / FindGEQ / remove):\n";
+    std::cout << "    CUradixTree (" << sizeof(CUradixNode) << " B/node):  " << std::fixed << std::setprecision(3)
+              << (radix_insert_time * 1000.0) / keys.size() << " / " << (radix_geq_time * 1000.0) / queries.size()
+              << " / " << (radix_remove_time * 1000.0) / keys.size() << " us/op\n";
+    std::cout << "    Crit-bit (" << sizeof(CUradixCritbitNode) << " B/node):     " << std::fixed << std::setprecision(3)
+              << (critbit_insert_time * 1000.0) / keys.size() << " / " << (critbit_geq_time * 1000.0) / queries.size()
+              << " / " << (critbit_remove_time * 1000.0) / keys.size() << " us/op ("
+              << (radix_sum == critbit_sum && radixTreeEmpty(&radix_tree) && radixCritbitTreeEmpty(&critbit_tree)
+                  ? "results match" : "RESULTS DIFFER") << ")\n";
+}
+
+// radixTreeFindGEQ vs radixTreeFindGEQBranchless. Throughput runs
+// independent queries; latency chains each query on the previous result so
+// that lookups can't overlap.
+void benchmark_geq_kernels(const char* name, const std::vector<NvU64>& keys, const std::vector<NvU64>& queries) {
+    Timer timer;
+    BranchMissCounter misses;
+    CUradixTree tree;
+    std::vector<CUradixNode> nodes(keys.size());
+    radixTreeInit(&tree, 64);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&tree, &nodes[i], keys[i]);
+    }
+    
+    auto run = [&](CUradixNode* (*find)(CUradixTree*, NvU64), bool chained, NvU64* sum, long long* miss_count) {
+        NvU64 local_sum = 0;
+        NvU64 prev = 0;
+        misses.start();
+        timer.start();
+        for (const auto& query : queries) {
+            CUradixNode* found = find(&tree, chained ? (query ^ (prev & 1)) : query);
+            prev = found ? found->key : 0;
+            local_sum += prev;
+        }
+        double time = timer.stop();
+        *miss_count = misses.stop();
+        *sum = local_sum;
+        return time;
+    };
+    
+    std::cout << "  " << name << " (" << keys.size() << " keys; throughput / latency, branch misses per query):\n";
+    NvU64 reference[2];
+    for (int kernel = 0; kernel < 2; ++kernel) {
+        CUradixNode* (*find)(CUradixTree*, NvU64) = kernel ? radixTreeFindGEQBranchless : radixTreeFindGEQ;
+        NvU64 sums[2];
+        long long miss_counts[2];
+        double throughput_time = run(find, false, &sums[0], &miss_counts[0]);
+        double latency_time = run(find, true, &sums[1], &miss_counts[1]);
+        bool match = true;
+        if (kernel == 0) {
+            reference[0] = sums[0];
+            reference[1] = sums[1];
+        } else {
+            match = (sums[0] == reference[0] && sums[1] == reference[1]);
+        }
+        std::cout << "    " << (kernel ? "Branchless: " : "FindGEQ:    ") << std::fixed << std::setprecision(3)
+                  << (throughput_time * 1000.0) / queries.size() << " / " << (latency_time * 1000.0) / queries.size()
+                  << " us/op, ";
+        if (miss_counts[0] < 0) {
+            std::cout << "n/a";
+        } else {
+            std::cout << std::setprecision(2) << (double)miss_counts[0] / queries.size() << " / "
+                      << (double)miss_counts[1] / queries.size();
+        }
+        if (kernel) {
+            std::cout << " (" << (match ? "results match" : "RESULTS DIFFER") << ")";
+        }
+        std::cout << "\n";
+    }
+}
+
+void benchmark_range_queries(const std::vector<NvU64>& keys) {
+    Timer timer;
+    
+    // Setup data structures
+    CUradixTree radix_tree;
+    std::vector<CUradixNode> nodes(keys.size());
+    radixTreeInit(&radix_tree, 64);
+    
+    WideRadixTree radix_new_tree;
+    treeInit(&radix_new_tree, 64, 8);
+    
+    RadixNewTemplate radix_new_template;
+    
+    wide_radix_tree_t wide_radix_tree;
+    wide_radix_init(&wide_radix_tree, 64);
+    
+    std::set<NvU64> std_set;
+    
+    for (size_t i = 0; i < keys.size(); ++i) {
+        radixTreeInsert(&radix_tree, &nodes[i], keys[i]);
+        uint64_t existing;
+        treeInsertOrReturnExisting(&radix_new_tree, keys[i], keys[i], &existing);
+        uint64_t* template_existing;
+        radix_new_template.insertOrReturnExisting(keys[i], keys[i], &template_existing);
+        wide_radix_insert(&wide_radix_tree, keys[i], keys[i]);
+        std_set.insert(keys[i]);
+    }
+    
+    // Test range queries (find smallest element >= query)
+    std::vector<NvU64> query_keys;
+    for (size_t i = 0; i < 10000; ++i) {
+        query_keys.push_back(keys[i % keys.size()] + (i % 100));
+    }
+    
+    // Radix tree range queries
+    timer.start();
+    size_t radix_found = 0;
+    for (const auto& query : query_keys) {
+        CUradixNode* found = radixTreeFindGEQ(&radix_tree, query);
+        if (found) radix_found++;
+    }
+    double radix_range_time = timer.stop();
+    
+    // New Radix tree range queries
+    timer.start();
+    size_t radix_new_found = 0;
+    for (const auto& query : query_keys) {
+        uint64_t found = treeFindGEQ(&radix_new_tree, query);
+        if (found != 0) radix_new_found++;
+    }
+    double radix_new_range_time = timer.stop();
+    
+    // Template radix tree range queries
+    timer.start();
+    size_t radix_new_template_found = 0;
+    for (const auto& query : query_keys) {
+        if (radix_new_template.findGEQ(query) != nullptr) radix_new_template_found++;
+    }
+    double radix_new_template_range_time = timer.stop();
+    
+    // Wide radix tree range queries
+    timer.start();
+    size_t wide_radix_found = 0;
+    for (const auto& query : query_keys) {
+        if (wide_radix_find_geq(&wide_radix_tree, query) != nullptr) wide_radix_found++;
+    }
+    double wide_radix_range_time = timer.stop();
+    
+    // std::set range queries
+    timer.start();
+    size_t set_found = 0;
+    for (const auto& query : query_keys) {
+        auto it = std_set.lower_bound(query);
+        if (it != std_set.end()) set_found++;
+    }
+    double set_range_time = timer.stop();
+    
+    // Cross-check wide_radix successors against std::set::lower_bound
+    size_t wide_radix_mismatches = 0;
+    for (const auto& query : query_keys) {
+        auto it = std_set.lower_bound(query);
+        NvU64 found_key;
+        NvU64* found = wide_radix_find_geq_key(&wide_radix_tree, query, &found_key);
+        if ((it == std_set.end()) != (found == nullptr) || (found && found_key != *it)) {
+            wide_radix_mismatches++;
+        }
+    }
+    
+    double radix_range_time_per_op = (radix_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    double radix_new_range_time_per_op = (radix_new_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    double radix_new_template_range_time_per_op = (radix_new_template_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    double wide_radix_range_time_per_op = (wide_radix_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    double set_range_time_per_op = (set_range_time * 1000.0) / query_keys.size();  // Convert to microseconds per operation
+    
+    std::cout << "Range Query Results (lower_bound/GEQ):\n";
+    std::cout << "  Radix Tree:     " << std::fixed << std::setprecision(3) << radix_range_time_per_op << " us/op (" << radix_found << " found)\n";
+    std::cout << "  Radix New Tree: " << std::fixed << std::setprecision(3) << radix_new_range_time_per_op << " us/op (" << radix_new_found << " found)\n";
+    std::cout << "  Radix New Tmpl: " << std::fixed << std::setprecision(3) << radix_new_template_range_time_per_op << " us/op (" << radix_new_template_found << " found)\n";
+    std::cout << "  Wide Radix:     " << std::fixed << std::setprecision(3) << wide_radix_range_time_per_op << " us/op (" << wide_radix_found << " found, "
+              << (wide_radix_mismatches ? "MISMATCHES vs std::set: " + std::to_string(wide_radix_mismatches) : std::string("matches std::set")) << ")\n";
+    std::cout << "  std::set:       " << std::fixed << std::setprecision(3) << set_range_time_per_op << " us/op (" << set_found << " found)\n\n";
+    
+    // Cleanup
+    treeDestroy(&radix_new_tree);
+    wide_radix_destroy(&wide_radix_tree);
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--large") == 0) {
+            g_large_runs = true;
+        }
+    }
+    
+    const size_t num_keys = 100000;
+    const size_t num_searches = 50000;
+    
+    std::cout << "Radix Tree vs C++ Standard Library Benchmark\n";
+    std::cout << "=============================================\n";
+    std::cout << "Dataset size: " << num_keys << " keys\n";
+    std::cout << "Search operations: " << num_searches << " lookups\n\n";
+    
+    // Generate random keys
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<NvU64> dis(1, 1000000);
+    
+    std::vector<NvU64> keys;
+    keys.reserve(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        keys.push_back(dis(gen));
+    }
+    
+    // Sort keys but keep duplicates since we're testing duplicate handling
+    std::sort(keys.begin(), keys.end());
+    
+    // Generate search keys (mix of existing and non-existing)
+    std::vector<NvU64> search_keys;
+    search_keys.reserve(num_searches);
     
     // 70% existing keys, 30% random keys
     for (size_t i = 0; i < num_searches * 0.7; ++i) {
@@ -401,10 +2348,113 @@ int main() {
     benchmark_std_set(keys, search_keys);
     benchmark_std_multiset(keys, search_keys);
     benchmark_wide_radix(keys, search_keys);
+    benchmark_wide_radix_churn(num_keys, g_large_runs ? 100000000 : 1000000);
+    std::cout << "Wide Radix Tree Teardown (malloc-backed vs arena-backed):\n";
+    benchmark_wide_radix_teardown(1000000);
+    if (g_large_runs) {
+        benchmark_wide_radix_teardown(10000000);
+    }
+    std::cout << "\n";
+    std::cout << "Wide Radix Tree Lookup by Key Width (levels from key_bits vs 64-bit tree):\n";
+    for (NvU32 key_bits : {16u, 32u, 48u, 64u}) {
+        benchmark_wide_radix_key_width(key_bits, num_keys);
+    }
+    std::cout << "\n";
     benchmark_radix_new(keys, search_keys);
+    benchmark_radix_new_template(keys, search_keys);
+    benchmark_radix_new_counts(keys, search_keys);
+    std::cout << "Radix New Tree Payload Lookup (pointer-chasing vs inline):\n";
+    benchmark_radix_new_payload<8>(keys, search_keys);
+    benchmark_radix_new_payload<16>(keys, search_keys);
+    benchmark_radix_new_payload<32>(keys, search_keys);
+    benchmark_radix_new_payload<64>(keys, search_keys);
+    std::cout << "\n";
     benchmark_libart(keys, search_keys);
     benchmark_avl_tree(keys, search_keys);
+    {
+        std::mt19937_64 avl_gen(91);
+        std::vector<NvU64> random_keys(1000000);
+        std::vector<NvU64> random_queries(1000000);
+        for (auto& key : random_keys) key = avl_gen();
+        for (size_t i = 0; i < random_queries.size(); ++i) {
+            // Half hits, half misses
+            random_queries[i] = (i & 1) ? avl_gen() : random_keys[avl_gen() % random_keys.size()];
+        }
+        std::cout << "AVL Tree Keys (generic comparator vs NvU64-keyed):\n";
+        benchmark_avl_u64("Dataset keys", keys, search_keys);
+        benchmark_avl_u64("Random 64-bit keys", random_keys, random_queries);
+        std::cout << "\n";
+        std::cout << "AVL Tree Bulk Build (node pool, cuAvlTreeBuildFromSorted):\n";
+        benchmark_avl_bulk_build("Dataset keys", keys, search_keys);
+        benchmark_avl_bulk_build("Random 64-bit keys", random_keys, random_queries);
+        std::cout << "\n";
+        std::cout << "AVL Tree Split/Join (range extraction vs per-node remove + insert):\n";
+        benchmark_avl_split_join(4000000);
+        std::cout << "\n";
+        std::cout << "AVL Tree Order Statistics (CU_AVL_TREE_FLAG_COUNTS):\n";
+        benchmark_avl_order_statistics(random_keys);
+        std::cout << "\n";
+    }
     benchmark_range_queries(keys);
+    benchmark_removal(keys);
+    benchmark_predecessor_queries(keys);
+    benchmark_best_fit_allocator(num_keys, 1000000);
+    benchmark_va_allocator(100000, 2000000);
+    benchmark_interval_queries(num_keys);
+    {
+        std::mt19937_64 stride_gen(77);
+        std::vector<NvU64> random_keys(1000000);
+        std::vector<NvU64> random_queries(1000000);
+        for (auto& key : random_keys) key = stride_gen();
+        for (auto& query : random_queries) query = stride_gen();
+        std::cout << "Stride Radix Tree (binary CUradixTree vs " << RADIX_STRIDE_FANOUT << "-way nodes):\n";
+        benchmark_stride_radix("Dataset keys", keys, search_keys);
+        benchmark_stride_radix("Random 64-bit keys", random_keys, random_queries);
+        std::cout << "\n";
+    }
+    {
+        std::mt19937_64 kernel_gen(55);
+        std::vector<NvU64> random_keys(1000000);
+        std::vector<NvU64> random_queries(1000000);
+        for (auto& key : random_keys) key = kernel_gen();
+        for (auto& query : random_queries) query = kernel_gen();
+        std::cout << "Crit-Bit Radix Tree (heap-ordered CUradixTree vs leaf-only PATRICIA):\n";
+        benchmark_critbit_radix("Dataset keys", keys, search_keys);
+        benchmark_critbit_radix("Random 64-bit keys", random_keys, random_queries);
+        std::cout << "\n";
+        std::cout << "Radix Tree GEQ Kernels (radixTreeFindGEQ vs radixTreeFindGEQBranchless):\n";
+        benchmark_geq_kernels("Dataset keys", keys, search_keys);
+        benchmark_geq_kernels("Random 64-bit keys", random_keys, random_queries);
+        std::cout << "\n";
+    }
+    std::cout << "Hinted Radix Tree Operations (radixTreeInsertNear / radixTreeFindGEQFrom):\n";
+    benchmark_hinted_radix(1000000);
+    std::cout << "\n";
+    std::cout << "Concurrent Radix Tree (" << std::thread::hardware_concurrency() << " hardware threads):\n";
+    for (int num_readers : {1, 2, 4}) {
+        benchmark_concurrent_radix(keys, num_readers);
+    }
+    std::cout << "\n";
+    std::cout << "Radix Tree Node Layout (FindGEQ, pointer nodes vs compact hot/cold arrays):\n";
+    benchmark_compact_layout(1000000);
+    if (g_large_runs) {
+        benchmark_compact_layout(100000000);
+    }
+    std::cout << "\n";
+    
+    // Duplicate-heavy workload: ~50 values per key, as in size-bucketed free lists
+    std::uniform_int_distribution<NvU64> bucket_dis(1, num_keys / 50);
+    std::vector<NvU64> dup_keys;
+    dup_keys.reserve(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        dup_keys.push_back(bucket_dis(gen) * 4096);
+    }
+    std::vector<NvU64> dup_search_keys;
+    dup_search_keys.reserve(num_searches);
+    for (size_t i = 0; i < num_searches; ++i) {
+        dup_search_keys.push_back(dup_keys[dis(gen) % dup_keys.size()]);
+    }
+    benchmark_duplicate_keys(dup_keys, dup_search_keys);
     
     return 0;
 } 
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "radix.h"
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,6 +20,34 @@ radixTreeGetSmallerNode(CUradixNode *firstNode, CUradixNode *potentialSecondNode
     return ((potentialSecondNode == NULL || firstNode->key < potentialSecondNode->key)? firstNode : potentialSecondNode);
 }
 
+// Largest node in the subtree. Keys under child[1] are larger than keys under
+// child[0] and a parent is smaller than its children, so this is the leaf
+// reached by preferring child[1].
+static inline CUradixNode *
+radixTreeSubtreeMax(CUradixNode *node)
+{
+    while (node->child[0] || node->child[1]) {
+        node = (node->child[1]? node->child[1] : node->child[0]);
+    }
+    return node;
+}
+
+// A node is primary (linked into the tree) if it owns a parent link; the
+// other nodes with the same key only sit on the primary's list.
+static inline NvBool
+radixTreeIsPrimary(CUradixNode *node)
+{
+    return (node->parent_to_self_ptr != NULL);
+}
+
+// Whether key lies under node's position, i.e. agrees with node's key on
+// every bit above the node's level
+static inline NvBool
+radixTreeCoversKey(CUradixNode *node, NvU64 key)
+{
+    return (node->cur_key_bit >= 64 || ((node->key ^ key) >> node->cur_key_bit) == 0);
+}
+
 static inline NvU32
 radixTreeIsBitSet(NvU64 key, NvU32 key_bit)
 {
@@ -98,6 +127,7 @@ radixTreeReplaceNode(CUradixNode *orig, CUradixNode *repl)
 
     repl->parent_to_self_ptr = orig->parent_to_self_ptr;
     repl->parent = orig->parent;
+    repl->cur_key_bit = orig->cur_key_bit;
 
     for (i = 0; i < 2; i++) {
         repl->child[i] = orig->child[i];
@@ -110,52 +140,6 @@ radixTreeReplaceNode(CUradixNode *orig, CUradixNode *repl)
     *(repl->parent_to_self_ptr) = repl;
 }
 
-// There are (15) pointers that need to be changed to swap a parent with its specified child
-static void
-radixTreeSwapParentWithChild(CUradixNode *oldParent, CUradixNode *oldChild)
-{
-    CU_ASSERT(oldChild->parent == oldParent);
-
-    unsigned i;
-    unsigned childNumber = (oldParent->child[1] == oldChild);
-    unsigned otherChildNumber = 1 - childNumber;
-    CUradixNode *swap_parent;
-    CUradixNode **swap_parent_to_self_ptr = oldParent->parent_to_self_ptr;
-    CUradixNode *oldChild_child[2];
-    for (i = 0; i < 2; i++) {
-        oldChild_child[i] = oldChild->child[i];
-    }
-
-    // Set parent_to_self_ptr of oldParent (2)
-    oldParent->parent_to_self_ptr = oldChild->child + childNumber;
-    *(oldParent->parent_to_self_ptr) = oldParent;
-
-    // Set the other child pointer of oldChild (3)
-    oldChild->child[otherChildNumber] = oldParent->child[otherChildNumber];
-    if (oldChild->child[otherChildNumber]) {
-        oldChild->child[otherChildNumber]->parent = oldChild;
-        oldChild->child[otherChildNumber]->parent_to_self_ptr = oldChild->child + otherChildNumber;
-    }
-
-    // Set parent_to_self_ptr of oldChild (2)
-    oldChild->parent_to_self_ptr = swap_parent_to_self_ptr;
-    *(oldChild->parent_to_self_ptr) = oldChild;
-
-    // Swap parent pointers (2)
-    swap_parent = oldParent->parent;
-    oldParent->parent = oldChild;
-    oldChild->parent = swap_parent;
-
-    // Set child pointers of oldParent (6)
-    for (i = 0; i < 2; i++) {
-        oldParent->child[i] = oldChild_child[i];
-        if (oldParent->child[i]) {
-            oldParent->child[i]->parent_to_self_ptr = &oldParent->child[i];
-            oldParent->child[i]->parent = oldParent;
-        }
-    }
-}
-
 // The tree is maintained so that at each time, the key of a parent node is
 // smaller than the key of its children. This allows us to make sure if we find
 // a node with a greater key on our path traversing the tree, it is the best
@@ -166,15 +150,13 @@ radixTreeSwapParentWithChild(CUradixNode *oldParent, CUradixNode *oldChild)
 // could be larger than some of its right subtree nodes that are better answers.
 // Keep in mind that in a radix tree, every node in a subtree is qualified
 // to be the parent node (has the correct bits for that location).
-void
-radixTreeInsert(CUradixTree *tree, CUradixNode *node, NvU64 key)
+//
+// The insertion starts at the position parent_to_self_ptr, at level
+// cur_key_bit; radixTreeInsert passes the root.
+static void
+radixTreeInsertAt(CUradixNode *parent, CUradixNode **parent_to_self_ptr, NvU32 cur_key_bit,
+                  CUradixNode *node, NvU64 key)
 {
-    CU_ASSERT(tree);
-    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
-    
-    CUradixNode *parent = NULL;
-    CUradixNode **parent_to_self_ptr = &tree->root;
-    NvU32 cur_key_bit = tree->key_bits;
     NvU32 child_to_take = 0;
 
     memset(node, 0, sizeof(*node));
@@ -215,16 +197,56 @@ radixTreeInsert(CUradixTree *tree, CUradixNode *node, NvU64 key)
         node->parent_to_self_ptr = parent_to_self_ptr;
         *(node->parent_to_self_ptr) = node;
         node->parent = parent; 
+        node->cur_key_bit = cur_key_bit;
     }
 }
 
-CUradixNode *
-radixTreeFindGEQ(CUradixTree *tree, NvU64 key)
+void
+radixTreeInsert(CUradixTree *tree, CUradixNode *node, NvU64 key)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
+
+    radixTreeInsertAt(NULL, &tree->root, tree->key_bits, node, key);
+}
+
+// The deepest ancestor of hint (or hint itself) that a search for key from
+// the root would reach: it agrees with key above its level and every node
+// above it is smaller than key. A non-primary hint stands for its primary.
+static CUradixNode *
+radixTreeHintStart(CUradixNode *hint, NvU64 key)
+{
+    while (!radixTreeIsPrimary(hint)) {
+        hint = hint->next;
+    }
+    while (hint->parent && (!radixTreeCoversKey(hint, key) || hint->parent->key >= key)) {
+        hint = hint->parent;
+    }
+    return hint;
+}
+
+void
+radixTreeInsertNear(CUradixTree *tree, CUradixNode *hint, CUradixNode *node, NvU64 key)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
+
+    if (hint == NULL) {
+        radixTreeInsertAt(NULL, &tree->root, tree->key_bits, node, key);
+        return;
+    }
+
+    CU_ASSERT(hint != node);
+    hint = radixTreeHintStart(hint, key);
+    radixTreeInsertAt(hint->parent, hint->parent_to_self_ptr, hint->cur_key_bit, node, key);
+}
+
+// GEQ search within the subtree at node, whose level is cur_key_bit
+static inline CUradixNode *
+radixTreeFindGEQBelow(CUradixNode *node, unsigned int cur_key_bit, NvU64 key)
 {
-    CUradixNode *node = tree->root;
     CUradixNode *found = NULL;
     CUradixNode *gt_tree = NULL;
-    unsigned int cur_key_bit = tree->key_bits;
     unsigned int child_to_take = 0;
 
     // We use key's bit representation to traverse the tree to
@@ -258,24 +280,233 @@ radixTreeFindGEQ(CUradixTree *tree, NvU64 key)
     return found;
 }
 
+CUradixNode *
+radixTreeFindGEQ(CUradixTree *tree, NvU64 key)
+{
+    return radixTreeFindGEQBelow(tree->root, tree->key_bits, key);
+}
+
+// Keys only grow going down the key's path, and every gt_tree candidate
+// passed on the way is larger than the whole subtree the path continues
+// into. So the first node on the path with a key >= key is the answer and
+// the walk can stop there; until then only the right-subtree capture is
+// left, which is done with selects rather than a branch on the key bit.
+// Both children of each node are prefetched before its key is compared,
+// overlapping the next level's miss with the current level's work.
+CUradixNode *
+radixTreeFindGEQBranchless(CUradixTree *tree, NvU64 key)
+{
+    CUradixNode *node = tree->root;
+    CUradixNode *gt_tree = NULL;
+    unsigned int cur_key_bit = tree->key_bits;
+
+    while (node) {
+        CUradixNode *right = node->child[1];
+        unsigned int child_to_take;
+        uintptr_t keep;
+
+        __builtin_prefetch(node->child[0]);
+        __builtin_prefetch(right);
+
+        if (node->key >= key) {
+            return node;
+        }
+
+        cur_key_bit--;
+        child_to_take = radixTreeIsBitSet(key, cur_key_bit);
+
+        // gt_tree = right if going left and right exists. Spelled as a mask
+        // since compilers turn the ternary form back into a branch.
+        keep = (uintptr_t)0 - (uintptr_t)(child_to_take | (right == NULL));
+        gt_tree = (CUradixNode *)(((uintptr_t)gt_tree & keep) | ((uintptr_t)right & ~keep));
+        node = node->child[child_to_take];
+    }
+
+    return gt_tree;
+}
+
+// Nodes above the start are smaller than key, so they can't be the answer.
+// If the start's subtree has nothing >= key, the answer is the right
+// sibling subtree of the deepest ancestor where the key's path goes left,
+// exactly the gt_tree a search from the root would have recorded.
+CUradixNode *
+radixTreeFindGEQFrom(CUradixNode *hint, NvU64 key)
+{
+    CUradixNode *node;
+    CUradixNode *found;
+
+    CU_ASSERT(hint);
+
+    node = radixTreeHintStart(hint, key);
+    found = radixTreeFindGEQBelow(node, node->cur_key_bit, key);
+    if (found) {
+        return found;
+    }
+
+    for (; node->parent; node = node->parent) {
+        if (node->parent->child[0] == node && node->parent->child[1]) {
+            return node->parent->child[1];
+        }
+    }
+    return NULL;
+}
+
+// Mirror image of radixTreeFindGEQ. Nodes on the key's path only get larger
+// as we go down, so the deepest one below the key is the best on the path.
+// Everything in a child[0] subtree we passed by going right is smaller than
+// the key; the deepest such subtree holds the largest of those keys, and its
+// maximum is compared with the best node on the path.
+CUradixNode *
+radixTreeFindLEQ(CUradixTree *tree, NvU64 key)
+{
+    CUradixNode *node = tree->root;
+    CUradixNode *found = NULL;
+    CUradixNode *lt_tree = NULL;
+    unsigned int cur_key_bit = tree->key_bits;
+    unsigned int child_to_take = 0;
+
+    while (node) {
+        if (node->key == key) {
+            return node;
+        }
+
+        if (node->key < key) {
+            found = node;
+        }
+
+        cur_key_bit--;
+        child_to_take = radixTreeIsBitSet(key, cur_key_bit);
+
+        // Record the left-subtree only if it exists but we're going right
+        if (child_to_take == 1 && node->child[0]) {
+            lt_tree = node->child[0];
+        }
+        node = node->child[child_to_take];
+    }
+
+    if (lt_tree) {
+        lt_tree = radixTreeSubtreeMax(lt_tree);
+        if (!found || lt_tree->key > found->key) {
+            found = lt_tree;
+        }
+    }
+
+    return found;
+}
+
+// Every key larger than a primary node is either below it, or in a child[1]
+// subtree hanging off its path at a point where the path went to child[0]
+// (keys there are larger than anything sharing the node's prefix). So the
+// successor is the node's smaller child if it has children, and otherwise the
+// child[1] of the deepest such branch point.
+static CUradixNode *
+radixTreeNextPrimary(CUradixNode *node)
+{
+    CUradixNode *child = radixTreeGetSmallerChild(node);
+    if (child) {
+        return child;
+    }
+
+    while (node->parent) {
+        CUradixNode *parent = node->parent;
+        if (node == parent->child[0] && parent->child[1]) {
+            return parent->child[1];
+        }
+        node = parent;
+    }
+    return NULL;
+}
+
+// The keys smaller than a primary node are its ancestors, the largest being
+// its parent, and the child[0] subtrees hanging off its path where the path
+// went to child[1]. Only the one directly under the parent can beat the
+// parent: deeper branch points are below the parent and hold larger keys.
+static CUradixNode *
+radixTreePrevPrimary(CUradixNode *node)
+{
+    CUradixNode *parent = node->parent;
+    if (parent && node == parent->child[1] && parent->child[0]) {
+        return radixTreeSubtreeMax(parent->child[0]);
+    }
+    return parent;
+}
+
+// Nodes with equal keys are visited primary first, then in list order.
+CUradixNode *
+radixTreeNext(CUradixNode *node)
+{
+    CU_ASSERT(node);
+
+    if (!radixTreeIsPrimary(node->next)) {
+        return node->next;
+    }
+    // Wrapped around to the primary, move on to the next key
+    return radixTreeNextPrimary(node->next);
+}
+
+CUradixNode *
+radixTreePrev(CUradixNode *node)
+{
+    CU_ASSERT(node);
+
+    if (!radixTreeIsPrimary(node)) {
+        return node->prev;
+    }
+    // The last node of the previous key is its primary's list tail
+    node = radixTreePrevPrimary(node);
+    return (node? node->prev : NULL);
+}
+
+// Removing a primary node with no duplicates would push it down to a leaf by
+// swapping it with its smaller child at every level. Instead, every node on
+// that smaller-child chain moves up one position in a single pass: the chain
+// node takes over the vacated position along with the sibling subtree there,
+// and its own former position becomes the next one to fill. The last
+// position on the chain is cut. Remove cannot simply splice a node out of
+// the middle of the tree, because the position of a node encodes its key
+// bits.
 void
 radixTreeRemove(CUradixNode *node)
 {
     CU_ASSERT(node);
 
     if (radixListEmpty(node)) {
-        CUradixNode *leastChild = radixTreeGetSmallerChild(node);
-        // 1. if it is a leaf, simply cut it out
-        if (leastChild == NULL) {
-            *(node->parent_to_self_ptr) = NULL;
-        }
-        // 2. if not, swap it with its smallest child and then 
-        // try to remove it again (i.e., push it down until it's a leaf).
-        // Note that remove cannot simply cut out a node from the middle of
-        // the tree, because it will impact the height of other nodes.
-        else {
-            radixTreeSwapParentWithChild(node, leastChild);
-            radixTreeRemove(node);
+        CUradixNode **slot = node->parent_to_self_ptr;
+        CUradixNode *parent = node->parent;
+        CUradixNode *children[2] = {node->child[0], node->child[1]};
+
+        for (;;) {
+            unsigned childNumber = (children[0]? 0 : 1);
+            CUradixNode *promoted = children[childNumber];
+            CUradixNode *sibling = children[1 - childNumber];
+            CUradixNode *promoted_child[2];
+
+            if (promoted == NULL) {
+                *slot = NULL;
+                break;
+            }
+
+            promoted_child[0] = promoted->child[0];
+            promoted_child[1] = promoted->child[1];
+
+            // Move promoted into the vacated position, one level up
+            *slot = promoted;
+            promoted->parent_to_self_ptr = slot;
+            promoted->parent = parent;
+            promoted->cur_key_bit++;
+
+            // It keeps the sibling subtree of that position
+            promoted->child[1 - childNumber] = sibling;
+            if (sibling) {
+                sibling->parent_to_self_ptr = &promoted->child[1 - childNumber];
+                sibling->parent = promoted;
+            }
+
+            // Its old position, below itself, is vacated next
+            slot = &promoted->child[childNumber];
+            parent = promoted;
+            children[0] = promoted_child[0];
+            children[1] = promoted_child[1];
         }
     }
     else {
@@ -288,4 +519,26 @@ radixTreeRemove(CUradixNode *node)
         }
         radixListRemove(node);
     }
-}
\ No newline at end of file
+}
+
+// Find-GEQ-and-remove for best-fit allocation. When the best key has
+// duplicates, the newest one is unlinked from the primary's list, which
+// leaves the tree untouched; otherwise the primary itself is removed.
+CUradixNode *
+radixTreeExtractGEQ(CUradixTree *tree, NvU64 key)
+{
+    CUradixNode *node = radixTreeFindGEQ(tree, key);
+
+    if (node == NULL) {
+        return NULL;
+    }
+
+    if (!radixListEmpty(node)) {
+        node = node->prev;
+        radixListRemove(node);
+        return node;
+    }
+
+    radixTreeRemove(node);
+    return node;
+}
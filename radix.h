@@ -21,6 +21,10 @@ struct CUradixNode_st
     struct CUradixNode_st *parent;
 
     NvU64 key; // Bits of this key will determine the location of a node
+
+    // Key bits below this node's level (key_bits at the root); its children
+    // branch on bit cur_key_bit - 1. Lets a search resume from any node.
+    NvU32 cur_key_bit;
 };
 
 // Generic radix tree type
@@ -45,6 +49,46 @@ radixTreeEmpty(CUradixTree *tree);
 CUDA_TEST_EXPORT CUradixNode *
 radixTreeFindGEQ(CUradixTree *tree, NvU64 key);
 
+// Same result as radixTreeFindGEQ from a loop with a single data-dependent
+// branch per level (the stop test); the right-subtree capture and the child
+// selection are conditional moves, and both children of each visited node
+// are prefetched.
+CUDA_TEST_EXPORT CUradixNode *
+radixTreeFindGEQBranchless(CUradixTree *tree, NvU64 key);
+
+// Returns the node with the largest key <= key, or NULL. As with
+// radixTreeFindGEQ the primary node of that key is returned; its duplicates
+// follow it in radixTreeNext order.
+CUDA_TEST_EXPORT CUradixNode *
+radixTreeFindLEQ(CUradixTree *tree, NvU64 key);
+
+// In-order iteration over all inserted nodes, including every node of a
+// duplicate key (primary first, then in insertion order). Returns NULL past
+// either end.
+CUDA_TEST_EXPORT CUradixNode *
+radixTreeNext(CUradixNode *node);
+
+CUDA_TEST_EXPORT CUradixNode *
+radixTreePrev(CUradixNode *node);
+
+// Finds the node with the smallest key >= key and removes it from the tree in
+// one call. A non-primary duplicate is preferred, since detaching it needs no
+// tree restructuring. Returns NULL if there is no such node.
+CUDA_TEST_EXPORT CUradixNode *
+radixTreeExtractGEQ(CUradixTree *tree, NvU64 key);
+
+// Finger variants for keys close to a node already in the tree. Instead of
+// the root they start at the deepest ancestor of hint whose subtree the key
+// belongs to, found by following parent links up until the node's prefix
+// matches the key and its parent is smaller than the key. The cost is the
+// distance between hint and key in the tree rather than the tree's depth.
+// hint must be in the tree; a NULL hint makes InsertNear a plain insert.
+CUDA_TEST_EXPORT void
+radixTreeInsertNear(CUradixTree *tree, CUradixNode *hint, CUradixNode *node, NvU64 key);
+
+CUDA_TEST_EXPORT CUradixNode *
+radixTreeFindGEQFrom(CUradixNode *hint, NvU64 key);
+
 #ifdef __cplusplus
 }
 #endif
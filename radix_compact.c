@@ -0,0 +1,324 @@
+#include "radix_compact.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+// The algorithms are those of radix.c; links that were pointers there are
+// handles here, and parent_to_self_ptr is recomputed from the parent's
+// children when a node has to be relinked.
+
+static inline NvU32
+radixCompactIsBitSet(NvU64 key, NvU32 key_bit)
+{
+    return ((key & (1ULL << key_bit)) != 0);
+}
+
+// The link (root or a parent's child slot) that points at a primary node
+static inline CUradixCompactHandle *
+radixCompactLinkOf(CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    CUradixCompactHandle parent = tree->cold[node].parent;
+    CUradixCompactHot *hot;
+
+    if (parent == RADIX_COMPACT_NULL) {
+        CU_ASSERT(tree->root == node);
+        return &tree->root;
+    }
+    hot = &tree->hot[parent];
+    return &hot->child[hot->child[1] == node];
+}
+
+static inline NvBool
+radixCompactIsPrimary(CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    return (tree->cold[node].parent != RADIX_COMPACT_NULL || tree->root == node);
+}
+
+static int
+radixCompactGrow(CUradixCompactTree *tree, NvU32 capacity)
+{
+    CUradixCompactHot *hot;
+    CUradixCompactCold *cold;
+
+    hot = (CUradixCompactHot *)realloc(tree->hot, (size_t)capacity * sizeof(*hot));
+    if (!hot) {
+        return -1;
+    }
+    tree->hot = hot;
+
+    cold = (CUradixCompactCold *)realloc(tree->cold, (size_t)capacity * sizeof(*cold));
+    if (!cold) {
+        return -1;
+    }
+    tree->cold = cold;
+
+    tree->capacity = capacity;
+    return 0;
+}
+
+static CUradixCompactHandle
+radixCompactAllocSlot(CUradixCompactTree *tree)
+{
+    CUradixCompactHandle node = tree->free_head;
+
+    if (node != RADIX_COMPACT_NULL) {
+        tree->free_head = tree->cold[node].next;
+        return node;
+    }
+
+    if (tree->used == tree->capacity) {
+        NvU32 capacity;
+        if (tree->capacity == 0xFFFFFFFFu) {
+            return RADIX_COMPACT_NULL;
+        }
+        capacity = (tree->capacity > 0x7FFFFFFFu)? 0xFFFFFFFFu : tree->capacity * 2;
+        if (radixCompactGrow(tree, capacity) != 0) {
+            return RADIX_COMPACT_NULL;
+        }
+    }
+    return tree->used++;
+}
+
+static void
+radixCompactFreeSlot(CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    tree->cold[node].next = tree->free_head;
+    tree->free_head = node;
+}
+
+static void
+radixCompactListInsert(CUradixCompactTree *tree, CUradixCompactHandle node, CUradixCompactHandle head)
+{
+    CUradixCompactCold *cold = tree->cold;
+    CUradixCompactHandle prev = cold[head].prev;
+
+    cold[prev].next = node;
+    cold[node].prev = prev;
+    cold[head].prev = node;
+    cold[node].next = head;
+}
+
+static void
+radixCompactListRemove(CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    CUradixCompactCold *cold = tree->cold;
+    CUradixCompactHandle next = cold[node].next;
+    CUradixCompactHandle prev = cold[node].prev;
+
+    cold[next].prev = prev;
+    cold[prev].next = next;
+}
+
+// Put repl, which must not be linked into the tree, in the place of the
+// primary node that *link points at
+static void
+radixCompactReplaceNode(CUradixCompactTree *tree, CUradixCompactHandle *link,
+                        CUradixCompactHandle orig, CUradixCompactHandle repl)
+{
+    int i;
+
+    tree->cold[repl].parent = tree->cold[orig].parent;
+    for (i = 0; i < 2; i++) {
+        CUradixCompactHandle child = tree->hot[orig].child[i];
+        tree->hot[repl].child[i] = child;
+        if (child != RADIX_COMPACT_NULL) {
+            tree->cold[child].parent = repl;
+        }
+    }
+    *link = repl;
+}
+
+int
+radixCompactTreeInit(CUradixCompactTree *tree, NvU32 key_bits, NvU32 initial_capacity)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(key_bits > 0);
+
+    memset(tree, 0, sizeof(*tree));
+    tree->key_bits = key_bits;
+    tree->used = 1;  // Slot 0 is RADIX_COMPACT_NULL
+
+    if (initial_capacity < 2) {
+        initial_capacity = 2;
+    }
+    if (radixCompactGrow(tree, initial_capacity) != 0) {
+        radixCompactTreeDestroy(tree);
+        return -1;
+    }
+    memset(&tree->hot[0], 0, sizeof(tree->hot[0]));
+    memset(&tree->cold[0], 0, sizeof(tree->cold[0]));
+    return 0;
+}
+
+void
+radixCompactTreeDestroy(CUradixCompactTree *tree)
+{
+    CU_ASSERT(tree);
+
+    free(tree->hot);
+    free(tree->cold);
+    memset(tree, 0, sizeof(*tree));
+}
+
+NvBool
+radixCompactTreeEmpty(CUradixCompactTree *tree)
+{
+    CU_ASSERT(tree);
+    return (tree->root == RADIX_COMPACT_NULL);
+}
+
+// See radixTreeInsert for why a smaller key displaces the node it meets
+CUradixCompactHandle
+radixCompactTreeInsert(CUradixCompactTree *tree, NvU64 key)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
+
+    // Allocate first: growing the arrays moves them
+    CUradixCompactHandle inserted = radixCompactAllocSlot(tree);
+    if (inserted == RADIX_COMPACT_NULL) {
+        return RADIX_COMPACT_NULL;
+    }
+
+    CUradixCompactHot *hot = tree->hot;
+    CUradixCompactCold *cold = tree->cold;
+    CUradixCompactHandle node = inserted;
+    CUradixCompactHandle parent = RADIX_COMPACT_NULL;
+    CUradixCompactHandle *link = &tree->root;
+    NvU32 cur_key_bit = tree->key_bits;
+
+    hot[node].key = key;
+    hot[node].child[0] = RADIX_COMPACT_NULL;
+    hot[node].child[1] = RADIX_COMPACT_NULL;
+    cold[node].parent = RADIX_COMPACT_NULL;
+    cold[node].next = node;
+    cold[node].prev = node;
+
+    while (*link != RADIX_COMPACT_NULL && hot[*link].key != key) {
+        CUradixCompactHandle cur = *link;
+
+        // If the node has a smaller key than the cur node, swap
+        // node<-->cur and try to insert node (now changed) again
+        if (hot[node].key < hot[cur].key) {
+            radixCompactReplaceNode(tree, link, cur, node);
+
+            node = cur;
+            cur = *link;
+
+            hot[node].child[0] = RADIX_COMPACT_NULL;
+            hot[node].child[1] = RADIX_COMPACT_NULL;
+            cold[node].parent = RADIX_COMPACT_NULL;
+        }
+
+        parent = cur;
+        CU_ASSERT(cur_key_bit > 0);
+        cur_key_bit--;
+        link = &hot[cur].child[radixCompactIsBitSet(hot[node].key, cur_key_bit)];
+    }
+
+    if (*link != RADIX_COMPACT_NULL) {
+        radixCompactListInsert(tree, node, *link);
+    }
+    else {
+        *link = node;
+        cold[node].parent = parent;
+    }
+
+    return inserted;
+}
+
+CUradixCompactHandle
+radixCompactTreeFindGEQ(CUradixCompactTree *tree, NvU64 key)
+{
+    const CUradixCompactHot *hot = tree->hot;
+    CUradixCompactHandle node = tree->root;
+    CUradixCompactHandle found = RADIX_COMPACT_NULL;
+    CUradixCompactHandle gt_tree = RADIX_COMPACT_NULL;
+    unsigned int cur_key_bit = tree->key_bits;
+
+    while (node != RADIX_COMPACT_NULL) {
+        const CUradixCompactHot *cur = &hot[node];
+        unsigned int child_to_take;
+
+        if (cur->key == key) {
+            return node;
+        }
+
+        // Deeper nodes on the path are larger, so the first one above the
+        // key is the best on the path
+        if (cur->key > key && found == RADIX_COMPACT_NULL) {
+            found = node;
+        }
+
+        cur_key_bit--;
+        child_to_take = radixCompactIsBitSet(key, cur_key_bit);
+
+        // Record the right-subtree only if it exists but we're going left
+        if (child_to_take == 0 && cur->child[1] != RADIX_COMPACT_NULL) {
+            gt_tree = cur->child[1];
+        }
+        node = cur->child[child_to_take];
+    }
+
+    if (found == RADIX_COMPACT_NULL) {
+        found = gt_tree;
+    }
+
+    return found;
+}
+
+// Same single-pass promotion along the smaller-child chain as radixTreeRemove
+void
+radixCompactTreeRemove(CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(node != RADIX_COMPACT_NULL && node < tree->used);
+
+    CUradixCompactHot *hot = tree->hot;
+    CUradixCompactCold *cold = tree->cold;
+
+    if (cold[node].next == node) {
+        CUradixCompactHandle *link = radixCompactLinkOf(tree, node);
+        CUradixCompactHandle parent = cold[node].parent;
+        CUradixCompactHandle children[2] = {hot[node].child[0], hot[node].child[1]};
+
+        for (;;) {
+            unsigned childNumber = (children[0] != RADIX_COMPACT_NULL)? 0 : 1;
+            CUradixCompactHandle promoted = children[childNumber];
+            CUradixCompactHandle sibling = children[1 - childNumber];
+
+            if (promoted == RADIX_COMPACT_NULL) {
+                *link = RADIX_COMPACT_NULL;
+                break;
+            }
+
+            children[0] = hot[promoted].child[0];
+            children[1] = hot[promoted].child[1];
+
+            *link = promoted;
+            cold[promoted].parent = parent;
+
+            hot[promoted].child[1 - childNumber] = sibling;
+            if (sibling != RADIX_COMPACT_NULL) {
+                cold[sibling].parent = promoted;
+            }
+
+            link = &hot[promoted].child[childNumber];
+            parent = promoted;
+        }
+    }
+    else {
+        // A primary hands its place to the next node on its list
+        if (radixCompactIsPrimary(tree, node)) {
+            radixCompactReplaceNode(tree, radixCompactLinkOf(tree, node), node, cold[node].next);
+        }
+        radixCompactListRemove(tree, node);
+    }
+
+    cold[node].parent = RADIX_COMPACT_NULL;
+    radixCompactFreeSlot(tree, node);
+}
@@ -0,0 +1,85 @@
+#ifndef __RADIX_COMPACT_H__
+#define __RADIX_COMPACT_H__
+
+#include "utils_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compact variant of CUradixTree with the same heap-ordered structure and
+// duplicate handling, but with the nodes owned by the tree and split in two
+// parallel arrays indexed by 32-bit handles:
+//
+// - hot:  key and children, the only fields radixCompactTreeFindGEQ reads
+//         (16 bytes, four nodes per cache line)
+// - cold: parent link and duplicate list, used only by insert and remove
+//
+// Handle 0 is never handed out and stands for "no node".
+
+typedef NvU32 CUradixCompactHandle;
+typedef struct CUradixCompactHot_st CUradixCompactHot;
+typedef struct CUradixCompactCold_st CUradixCompactCold;
+typedef struct CUradixCompactTree_st CUradixCompactTree;
+
+#define RADIX_COMPACT_NULL 0
+
+struct CUradixCompactHot_st
+{
+    NvU64 key;
+    CUradixCompactHandle child[2];
+};
+
+struct CUradixCompactCold_st
+{
+    CUradixCompactHandle parent; // RADIX_COMPACT_NULL for the root and for non-primary nodes
+    CUradixCompactHandle next;   // Duplicate list; free slots are chained through next
+    CUradixCompactHandle prev;
+};
+
+struct CUradixCompactTree_st
+{
+    CUradixCompactHot *hot;
+    CUradixCompactCold *cold;
+    NvU32 capacity;              // Slots allocated in hot/cold
+    NvU32 used;                  // Slots ever handed out, including slot 0
+    CUradixCompactHandle free_head;
+    CUradixCompactHandle root;
+    unsigned int key_bits;
+};
+
+// Returns 0 on success, -1 if the initial arrays cannot be allocated.
+// initial_capacity is a hint; the arrays grow on demand.
+CUDA_TEST_EXPORT int
+radixCompactTreeInit(CUradixCompactTree *tree, NvU32 key_bits, NvU32 initial_capacity);
+
+CUDA_TEST_EXPORT void
+radixCompactTreeDestroy(CUradixCompactTree *tree);
+
+// Inserts key and returns the handle of its node, or RADIX_COMPACT_NULL if
+// the arrays cannot grow. Handles stay valid until the node is removed.
+CUDA_TEST_EXPORT CUradixCompactHandle
+radixCompactTreeInsert(CUradixCompactTree *tree, NvU64 key);
+
+CUDA_TEST_EXPORT void
+radixCompactTreeRemove(CUradixCompactTree *tree, CUradixCompactHandle node);
+
+CUDA_TEST_EXPORT NvBool
+radixCompactTreeEmpty(CUradixCompactTree *tree);
+
+// Same semantics as radixTreeFindGEQ: returns the primary node of the
+// smallest key >= key, or RADIX_COMPACT_NULL.
+CUDA_TEST_EXPORT CUradixCompactHandle
+radixCompactTreeFindGEQ(CUradixCompactTree *tree, NvU64 key);
+
+static inline NvU64
+radixCompactTreeKey(const CUradixCompactTree *tree, CUradixCompactHandle node)
+{
+    return tree->hot[node].key;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+#include "radix_concurrent.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+// Readers load node fields while a writer may be storing them through the
+// plain stores in radix.c. The relaxed atomic loads keep the compiler from
+// caching or splitting them; aligned pointer and key stores don't tear on
+// the targets we build for, and anything inconsistent that a reader does
+// see is thrown away when the sequence check fails.
+#define RADIX_LOAD(p) __atomic_load_n(&(p), __ATOMIC_RELAXED)
+
+void
+radixConcurrentTreeInit(CUradixConcurrentTree *tree, NvU32 key_bits)
+{
+    CU_ASSERT(tree);
+
+    memset(tree, 0, sizeof(*tree));
+    radixTreeInit(&tree->tree, key_bits);
+    pthread_mutex_init(&tree->writer_lock, NULL);
+}
+
+void
+radixConcurrentTreeDestroy(CUradixConcurrentTree *tree)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->readers[0] == 0 && tree->readers[1] == 0);
+
+    pthread_mutex_destroy(&tree->writer_lock);
+}
+
+// Called with writer_lock held. The odd count is published before any tree
+// store and the even count after the last one.
+static void
+radixConcurrentWriteBegin(CUradixConcurrentTree *tree)
+{
+    __atomic_store_n(&tree->seq, tree->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void
+radixConcurrentWriteEnd(CUradixConcurrentTree *tree)
+{
+    __atomic_store_n(&tree->seq, tree->seq + 1, __ATOMIC_RELEASE);
+}
+
+// Optimistic readers register in the counter of the current phase. The
+// phase is checked again after registering: a reader that raced with a
+// phase flip backs out before touching the tree, so a grace period never
+// misses a reader that could see an unlinked node.
+static unsigned
+radixConcurrentReadLock(CUradixConcurrentTree *tree)
+{
+    for (;;) {
+        unsigned phase = __atomic_load_n(&tree->reader_phase, __ATOMIC_SEQ_CST) & 1;
+
+        __atomic_fetch_add(&tree->readers[phase], 1, __ATOMIC_SEQ_CST);
+        if ((__atomic_load_n(&tree->reader_phase, __ATOMIC_SEQ_CST) & 1) == phase) {
+            return phase;
+        }
+        __atomic_fetch_sub(&tree->readers[phase], 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void
+radixConcurrentReadUnlock(CUradixConcurrentTree *tree, unsigned phase)
+{
+    __atomic_fetch_sub(&tree->readers[phase], 1, __ATOMIC_RELEASE);
+}
+
+// Called with writer_lock held, after the node has been unlinked. Readers
+// that register from now on see the phase flip, and with it the unlink; the
+// ones registered before are waited out.
+static void
+radixConcurrentSynchronize(CUradixConcurrentTree *tree)
+{
+    unsigned phase = __atomic_fetch_add(&tree->reader_phase, 1, __ATOMIC_SEQ_CST) & 1;
+
+    while (__atomic_load_n(&tree->readers[phase], __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+}
+
+void
+radixConcurrentTreeInsert(CUradixConcurrentTree *tree, CUradixNode *node, NvU64 key)
+{
+    CU_ASSERT(tree);
+
+    pthread_mutex_lock(&tree->writer_lock);
+    radixConcurrentWriteBegin(tree);
+    radixTreeInsert(&tree->tree, node, key);
+    radixConcurrentWriteEnd(tree);
+    pthread_mutex_unlock(&tree->writer_lock);
+}
+
+// Removal only moves the surviving nodes around (list promotion or the
+// smaller-child chain), so node is the only memory that may go away.
+void
+radixConcurrentTreeRemove(CUradixConcurrentTree *tree, CUradixNode *node)
+{
+    CU_ASSERT(tree);
+
+    pthread_mutex_lock(&tree->writer_lock);
+    radixConcurrentWriteBegin(tree);
+    radixTreeRemove(node);
+    radixConcurrentWriteEnd(tree);
+    radixConcurrentSynchronize(tree);
+    pthread_mutex_unlock(&tree->writer_lock);
+}
+
+// radixTreeFindGEQ over a tree that may be changing underneath. Returns
+// false if the walk ran into a shape no consistent tree has (a path deeper
+// than key_bits); the caller retries in that case just as for a sequence
+// mismatch.
+static NvBool
+radixConcurrentFindGEQOnce(CUradixConcurrentTree *tree, NvU64 key,
+                           CUradixNode **result, NvU64 *result_key)
+{
+    CUradixNode *node = RADIX_LOAD(tree->tree.root);
+    CUradixNode *found = NULL;
+    CUradixNode *gt_tree = NULL;
+    NvU64 found_key = 0;
+    unsigned int cur_key_bit = tree->tree.key_bits;
+
+    while (node) {
+        NvU64 node_key = RADIX_LOAD(node->key);
+        unsigned int child_to_take;
+        CUradixNode *right;
+
+        if (node_key == key) {
+            found = node;
+            found_key = node_key;
+            break;
+        }
+
+        if (node_key > key && (found == NULL || node_key < found_key)) {
+            found = node;
+            found_key = node_key;
+        }
+
+        if (cur_key_bit == 0) {
+            return 0;
+        }
+        cur_key_bit--;
+        child_to_take = (unsigned int)((key >> cur_key_bit) & 1);
+
+        right = RADIX_LOAD(node->child[1]);
+        if (child_to_take == 0 && right) {
+            gt_tree = right;
+        }
+        node = (child_to_take == 0)? RADIX_LOAD(node->child[0]) : right;
+    }
+
+    if (!found && gt_tree) {
+        found = gt_tree;
+        found_key = RADIX_LOAD(gt_tree->key);
+    }
+
+    *result = found;
+    *result_key = found_key;
+    return 1;
+}
+
+CUradixNode *
+radixConcurrentTreeFindGEQ(CUradixConcurrentTree *tree, NvU64 key, NvU64 *found_key)
+{
+    CUradixNode *found = NULL;
+    NvU64 result_key = 0;
+    int attempt;
+
+    CU_ASSERT(tree);
+
+    for (attempt = 0; attempt < RADIX_CONCURRENT_MAX_RETRIES; attempt++) {
+        unsigned phase;
+        NvU64 seq_begin;
+        NvBool consistent;
+
+        seq_begin = __atomic_load_n(&tree->seq, __ATOMIC_ACQUIRE);
+        if (seq_begin & 1) {
+            sched_yield();
+            continue;
+        }
+
+        phase = radixConcurrentReadLock(tree);
+        consistent = radixConcurrentFindGEQOnce(tree, key, &found, &result_key);
+        radixConcurrentReadUnlock(tree, phase);
+
+        // Order the node loads above before the validating load of seq
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (consistent && __atomic_load_n(&tree->seq, __ATOMIC_RELAXED) == seq_begin) {
+            if (found_key) {
+                *found_key = result_key;
+            }
+            return found;
+        }
+    }
+
+    // Too many writers got in the way; read under the writer lock instead
+    pthread_mutex_lock(&tree->writer_lock);
+    found = radixTreeFindGEQ(&tree->tree, key);
+    result_key = found? found->key : 0;
+    pthread_mutex_unlock(&tree->writer_lock);
+
+    if (found_key) {
+        *found_key = result_key;
+    }
+    return found;
+}
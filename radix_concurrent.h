@@ -0,0 +1,65 @@
+#ifndef __RADIX_CONCURRENT_H__
+#define __RADIX_CONCURRENT_H__
+
+#include <pthread.h>
+#include "radix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Concurrency wrapper around CUradixTree.
+//
+// Writers (insert/remove) serialize on a mutex and bump a sequence counter
+// around every modification, making it odd while the tree is in flux.
+// Readers (FindGEQ) take no lock: they walk the tree optimistically and
+// retry if the sequence counter was odd or changed during the walk. After
+// RADIX_CONCURRENT_MAX_RETRIES failed attempts a reader falls back to the
+// writer mutex, so readers cannot starve under a steady stream of writes.
+//
+// An optimistic reader may still be walking a node that a writer has just
+// unlinked, so remove waits for a grace period: every reader that might
+// have seen the node has left its read section before remove returns, and
+// the caller can then free or reuse the node. Nodes that are only moved
+// within the tree stay valid memory throughout.
+#define RADIX_CONCURRENT_MAX_RETRIES 8
+
+typedef struct CUradixConcurrentTree_st CUradixConcurrentTree;
+
+struct CUradixConcurrentTree_st
+{
+    CUradixTree tree;
+    pthread_mutex_t writer_lock;
+
+    // Accessed with __atomic builtins; each on its own cache line so that
+    // reader bookkeeping doesn't contend with the sequence counter
+    NvU64 seq __attribute__((aligned(64)));
+    NvU32 reader_phase __attribute__((aligned(64)));
+    NvU64 readers[2] __attribute__((aligned(64)));  // Readers in flight, per phase
+};
+
+CUDA_TEST_EXPORT void
+radixConcurrentTreeInit(CUradixConcurrentTree *tree, NvU32 key_bits);
+
+CUDA_TEST_EXPORT void
+radixConcurrentTreeDestroy(CUradixConcurrentTree *tree);
+
+CUDA_TEST_EXPORT void
+radixConcurrentTreeInsert(CUradixConcurrentTree *tree, CUradixNode *node, NvU64 key);
+
+// Returns once no reader can still be looking at node.
+CUDA_TEST_EXPORT void
+radixConcurrentTreeRemove(CUradixConcurrentTree *tree, CUradixNode *node);
+
+// Returns the node with the smallest key >= key, or NULL, and stores that
+// key in *found_key if given. The key is read consistently with the node;
+// the node itself may be removed by a writer as soon as this returns, so
+// callers that dereference it need their own agreement with the writers.
+CUDA_TEST_EXPORT CUradixNode *
+radixConcurrentTreeFindGEQ(CUradixConcurrentTree *tree, NvU64 key, NvU64 *found_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
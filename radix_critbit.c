@@ -0,0 +1,300 @@
+#include "radix_critbit.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+static inline NvBool
+radixCritbitIsBranch(CUradixCritbitLink link)
+{
+    return (link & 1) != 0;
+}
+
+static inline CUradixCritbitBranch *
+radixCritbitBranchOf(CUradixCritbitLink link)
+{
+    return (CUradixCritbitBranch *)(link - 1);
+}
+
+static inline CUradixCritbitNode *
+radixCritbitLeafOf(CUradixCritbitLink link)
+{
+    return (CUradixCritbitNode *)link;
+}
+
+static inline CUradixCritbitLink
+radixCritbitBranchLink(CUradixCritbitBranch *branch)
+{
+    return (CUradixCritbitLink)branch | 1;
+}
+
+static inline CUradixCritbitLink
+radixCritbitLeafLink(CUradixCritbitNode *node)
+{
+    return (CUradixCritbitLink)node;
+}
+
+static inline unsigned int
+radixCritbitDirection(NvU64 key, NvU32 bit)
+{
+    return (unsigned int)((key >> bit) & 1);
+}
+
+// Highest bit in which two different keys differ
+static inline NvU32
+radixCritbitCritBit(NvU64 a, NvU64 b)
+{
+    return 63 - (NvU32)__builtin_clzll(a ^ b);
+}
+
+static void
+radixCritbitListInit(CUradixCritbitNode *node)
+{
+    CU_ASSERT(node);
+
+    node->next = node;
+    node->prev = node;
+}
+
+static void
+radixCritbitListInsert(CUradixCritbitNode *node, CUradixCritbitNode *head)
+{
+    CU_ASSERT(node);
+    CU_ASSERT(head);
+
+    CUradixCritbitNode *prev = head->prev;
+    prev->next = node;
+    node->prev = prev;
+    head->prev = node;
+    node->next = head;
+}
+
+static void
+radixCritbitListRemove(CUradixCritbitNode *node)
+{
+    CU_ASSERT(node);
+
+    CUradixCritbitNode *next = node->next;
+    CUradixCritbitNode *prev = node->prev;
+
+    next->prev = prev;
+    prev->next = next;
+}
+
+static int
+radixCritbitListEmpty(CUradixCritbitNode *node)
+{
+    CU_ASSERT(node);
+    return node->next == node;
+}
+
+// Record that the subtree at link now hangs from *parent_to_self_ptr
+static void
+radixCritbitSetPosition(CUradixCritbitLink link, CUradixCritbitLink *parent_to_self_ptr,
+                        CUradixCritbitBranch *parent)
+{
+    if (radixCritbitIsBranch(link)) {
+        CUradixCritbitBranch *branch = radixCritbitBranchOf(link);
+        branch->parent_to_self_ptr = parent_to_self_ptr;
+        branch->parent = parent;
+    }
+    else {
+        CUradixCritbitNode *node = radixCritbitLeafOf(link);
+        node->parent_to_self_ptr = parent_to_self_ptr;
+        node->parent = parent;
+    }
+}
+
+// Move a branch that is in use into the unused storage repl
+static void
+radixCritbitMoveBranch(CUradixCritbitBranch *orig, CUradixCritbitBranch *repl)
+{
+    int i;
+    CU_ASSERT(orig->parent_to_self_ptr);
+    CU_ASSERT(repl->parent_to_self_ptr == NULL);
+
+    *repl = *orig;
+    *(repl->parent_to_self_ptr) = radixCritbitBranchLink(repl);
+    for (i = 0; i < 2; i++) {
+        radixCritbitSetPosition(repl->child[i], &repl->child[i], repl);
+    }
+    orig->parent_to_self_ptr = NULL;
+}
+
+void
+radixCritbitTreeInit(CUradixCritbitTree *tree, NvU32 key_bits)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(key_bits > 0 && key_bits <= 64);
+
+    memset(tree, 0, sizeof(*tree));
+    tree->key_bits = key_bits;
+}
+
+NvBool
+radixCritbitTreeEmpty(CUradixCritbitTree *tree)
+{
+    CU_ASSERT(tree);
+    return (tree->root == 0);
+}
+
+// The leaf reached by following key's bits shares the longest prefix with
+// key of all leaves, which gives the crit bit of the new key. The new
+// node's branch then goes in above the first position on key's path that
+// tests a lower bit, with that whole subtree on one side and the new leaf
+// on the other.
+void
+radixCritbitTreeInsert(CUradixCritbitTree *tree, CUradixCritbitNode *node, NvU64 key)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
+
+    CUradixCritbitLink link = tree->root;
+    CUradixCritbitLink *parent_to_self_ptr = &tree->root;
+    CUradixCritbitBranch *parent = NULL;
+    CUradixCritbitBranch *branch = &node->branch;
+    CUradixCritbitNode *leaf;
+    NvU32 crit_bit;
+    unsigned int dir;
+
+    memset(node, 0, sizeof(*node));
+    node->key = key;
+    radixCritbitListInit(node);
+
+    if (link == 0) {
+        tree->root = radixCritbitLeafLink(node);
+        node->parent_to_self_ptr = &tree->root;
+        return;
+    }
+
+    while (radixCritbitIsBranch(link)) {
+        CUradixCritbitBranch *cur = radixCritbitBranchOf(link);
+        link = cur->child[radixCritbitDirection(key, cur->bit)];
+    }
+    leaf = radixCritbitLeafOf(link);
+
+    if (leaf->key == key) {
+        radixCritbitListInsert(node, leaf);
+        return;
+    }
+
+    crit_bit = radixCritbitCritBit(leaf->key, key);
+    while (radixCritbitIsBranch(*parent_to_self_ptr) &&
+           radixCritbitBranchOf(*parent_to_self_ptr)->bit > crit_bit) {
+        parent = radixCritbitBranchOf(*parent_to_self_ptr);
+        parent_to_self_ptr = &parent->child[radixCritbitDirection(key, parent->bit)];
+    }
+
+    dir = radixCritbitDirection(key, crit_bit);
+    branch->bit = crit_bit;
+    branch->child[dir] = radixCritbitLeafLink(node);
+    branch->child[1 - dir] = *parent_to_self_ptr;
+    radixCritbitSetPosition(branch->child[1 - dir], &branch->child[1 - dir], branch);
+    node->parent_to_self_ptr = &branch->child[dir];
+    node->parent = branch;
+
+    branch->parent_to_self_ptr = parent_to_self_ptr;
+    branch->parent = parent;
+    *parent_to_self_ptr = radixCritbitBranchLink(branch);
+}
+
+// As in insert, the leaf on key's path gives the crit bit. The subtree at
+// the crit bit's position on the path holds the keys sharing key's prefix
+// above it; if key has a 0 there they are all larger and the answer is the
+// subtree's minimum. Otherwise they are all smaller and the answer is the
+// minimum of the deepest child[1] subtree passed over on the way down.
+CUradixCritbitNode *
+radixCritbitTreeFindGEQ(CUradixCritbitTree *tree, NvU64 key)
+{
+    CUradixCritbitLink link = tree->root;
+    CUradixCritbitLink gt_tree = 0;
+    CUradixCritbitNode *leaf;
+    NvU32 crit_bit;
+
+    if (link == 0) {
+        return NULL;
+    }
+
+    while (radixCritbitIsBranch(link)) {
+        CUradixCritbitBranch *cur = radixCritbitBranchOf(link);
+        link = cur->child[radixCritbitDirection(key, cur->bit)];
+    }
+    leaf = radixCritbitLeafOf(link);
+
+    if (leaf->key == key) {
+        return leaf;
+    }
+
+    crit_bit = radixCritbitCritBit(leaf->key, key);
+    link = tree->root;
+    while (radixCritbitIsBranch(link) && radixCritbitBranchOf(link)->bit > crit_bit) {
+        CUradixCritbitBranch *cur = radixCritbitBranchOf(link);
+        unsigned int dir = radixCritbitDirection(key, cur->bit);
+
+        if (dir == 0) {
+            gt_tree = cur->child[1];
+        }
+        link = cur->child[dir];
+    }
+
+    if (radixCritbitDirection(key, crit_bit)) {
+        link = gt_tree;
+        if (link == 0) {
+            return NULL;
+        }
+    }
+
+    while (radixCritbitIsBranch(link)) {
+        link = radixCritbitBranchOf(link)->child[0];
+    }
+    return radixCritbitLeafOf(link);
+}
+
+// The leaf's sibling subtree takes the place of their parent branch, which
+// is then free. Only a removed node's own branch may still be in use; it is
+// moved into the freed storage so that nothing in the tree refers to the
+// removed node afterwards.
+void
+radixCritbitTreeRemove(CUradixCritbitNode *node)
+{
+    CU_ASSERT(node);
+
+    if (!radixCritbitListEmpty(node)) {
+        // A primary hands its leaf position, and its branch if it owns one
+        // in use, to the next node on its list
+        if (node->parent_to_self_ptr) {
+            CUradixCritbitNode *next = node->next;
+
+            *(node->parent_to_self_ptr) = radixCritbitLeafLink(next);
+            next->parent_to_self_ptr = node->parent_to_self_ptr;
+            next->parent = node->parent;
+            if (node->branch.parent_to_self_ptr) {
+                radixCritbitMoveBranch(&node->branch, &next->branch);
+            }
+        }
+        radixCritbitListRemove(node);
+    }
+    else if (node->parent == NULL) {
+        // The only leaf; a one-leaf tree has no branches
+        *(node->parent_to_self_ptr) = 0;
+    }
+    else {
+        CUradixCritbitBranch *parent = node->parent;
+        unsigned int side = (parent->child[1] == radixCritbitLeafLink(node));
+        CUradixCritbitLink sibling = parent->child[1 - side];
+
+        *(parent->parent_to_self_ptr) = sibling;
+        radixCritbitSetPosition(sibling, parent->parent_to_self_ptr, parent->parent);
+        parent->parent_to_self_ptr = NULL;
+
+        if (node->branch.parent_to_self_ptr) {
+            radixCritbitMoveBranch(&node->branch, parent);
+        }
+    }
+
+    node->parent_to_self_ptr = NULL;
+    node->parent = NULL;
+}
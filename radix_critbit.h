@@ -0,0 +1,75 @@
+#ifndef __RADIX_CRITBIT_H__
+#define __RADIX_CRITBIT_H__
+
+#include "utils_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Intrusive PATRICIA (crit-bit) tree with the CUradixTree API. User nodes
+// are only ever leaves; each internal node tests a single bit, the highest
+// one in which the keys of its two subtrees differ, so the tree holds no
+// one-child nodes and is no deeper than key_bits or the number of leaves.
+//
+// A tree of n leaves needs n - 1 branches. Every user node embeds one, and
+// an insert puts the new node's own branch above it, so existing nodes and
+// branches are never moved by an insert. Removing a leaf also retires its
+// parent branch; if the removed node's embedded branch was still in use
+// elsewhere, it is relocated into the retired branch's storage. Nodes with
+// equal keys share one leaf position through a list, as in radix.c.
+//
+// Links to a child are tagged pointers: bit 0 set means a branch.
+typedef uintptr_t CUradixCritbitLink;
+
+typedef struct CUradixCritbitBranch_st CUradixCritbitBranch;
+typedef struct CUradixCritbitNode_st CUradixCritbitNode;
+typedef struct CUradixCritbitTree_st CUradixCritbitTree;
+
+struct CUradixCritbitBranch_st
+{
+    CUradixCritbitLink child[2];
+    CUradixCritbitLink *parent_to_self_ptr;  // NULL while the branch is unused
+    CUradixCritbitBranch *parent;
+    NvU32 bit;  // Keys under child[1] have this bit set, keys under child[0] don't
+};
+
+struct CUradixCritbitNode_st
+{
+    struct CUradixCritbitNode_st *next;
+    struct CUradixCritbitNode_st *prev;
+
+    CUradixCritbitLink *parent_to_self_ptr;  // NULL for non-primary duplicates
+    CUradixCritbitBranch *parent;
+
+    CUradixCritbitBranch branch;  // Storage for one internal node of the tree
+
+    NvU64 key;
+};
+
+struct CUradixCritbitTree_st
+{
+    CUradixCritbitLink root;
+    unsigned int key_bits;
+};
+
+CUDA_TEST_EXPORT void
+radixCritbitTreeInit(CUradixCritbitTree *tree, NvU32 key_bits);
+
+CUDA_TEST_EXPORT void
+radixCritbitTreeInsert(CUradixCritbitTree *tree, CUradixCritbitNode *node, NvU64 key);
+
+CUDA_TEST_EXPORT void
+radixCritbitTreeRemove(CUradixCritbitNode *node);
+
+CUDA_TEST_EXPORT NvBool
+radixCritbitTreeEmpty(CUradixCritbitTree *tree);
+
+CUDA_TEST_EXPORT CUradixCritbitNode *
+radixCritbitTreeFindGEQ(CUradixCritbitTree *tree, NvU64 key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
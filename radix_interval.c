@@ -0,0 +1,379 @@
+#include "radix_interval.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+// The structure is the same heap-ordered radix tree as radix.c (a parent's
+// start is smaller than its children's starts, and keys under child[0] are
+// smaller than keys under child[1]); the insert/remove code below mirrors
+// radixTreeInsert/radixTreeRemove and additionally refreshes max_end along
+// the one path whose nodes they moved.
+
+static inline NvU32
+radixIntervalIsBitSet(NvU64 key, NvU32 key_bit)
+{
+    return ((key & (1ULL << key_bit)) != 0);
+}
+
+static void
+radixIntervalListInit(CUradixIntervalNode *node)
+{
+    CU_ASSERT(node);
+
+    node->next = node;
+    node->prev = node;
+}
+
+static void
+radixIntervalListInsert(CUradixIntervalNode *node, CUradixIntervalNode *head)
+{
+    CU_ASSERT(node);
+    CU_ASSERT(head);
+
+    CUradixIntervalNode *prev = head->prev;
+    prev->next = node;
+    node->prev = prev;
+    head->prev = node;
+    node->next = head;
+}
+
+static void
+radixIntervalListRemove(CUradixIntervalNode *node)
+{
+    CU_ASSERT(node);
+
+    CUradixIntervalNode *next = node->next;
+    CUradixIntervalNode *prev = node->prev;
+
+    next->prev = prev;
+    prev->next = next;
+}
+
+static int
+radixIntervalListEmpty(CUradixIntervalNode *node)
+{
+    CU_ASSERT(node);
+    return node->next == node;
+}
+
+// Largest end among a primary node and its duplicates
+static NvU64
+radixIntervalListMaxEnd(CUradixIntervalNode *node)
+{
+    NvU64 max_end = node->end;
+    CUradixIntervalNode *dup;
+
+    for (dup = node->next; dup != node; dup = dup->next) {
+        if (dup->end > max_end) {
+            max_end = dup->end;
+        }
+    }
+    return max_end;
+}
+
+// Recompute max_end from node up to the root. Every insert or remove only
+// moves nodes along a single path, so refreshing that path bottom-up is
+// enough to restore the augmentation.
+static void
+radixIntervalTreeUpdatePath(CUradixIntervalNode *node)
+{
+    while (node) {
+        NvU64 max_end = radixIntervalListMaxEnd(node);
+        int i;
+
+        for (i = 0; i < 2; i++) {
+            if (node->child[i] && node->child[i]->max_end > max_end) {
+                max_end = node->child[i]->max_end;
+            }
+        }
+        node->max_end = max_end;
+        node = node->parent;
+    }
+}
+
+void
+radixIntervalTreeInit(CUradixIntervalTree *tree, NvU32 key_bits)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(key_bits > 0);
+
+    memset(tree, 0, sizeof(*tree));
+    tree->key_bits = key_bits;
+}
+
+NvBool
+radixIntervalTreeEmpty(CUradixIntervalTree *tree)
+{
+    CU_ASSERT(tree);
+    return (tree->root == NULL);
+}
+
+// Same contract as radixTreeReplaceNode: repl must be detached or a
+// non-primary node of the list.
+static void
+radixIntervalTreeReplaceNode(CUradixIntervalNode *orig, CUradixIntervalNode *repl)
+{
+    int i;
+    CU_ASSERT(repl->child[0] == NULL);
+    CU_ASSERT(repl->child[1] == NULL);
+    CU_ASSERT(repl->parent == NULL);
+    CU_ASSERT(repl->parent_to_self_ptr == NULL);
+
+    repl->parent_to_self_ptr = orig->parent_to_self_ptr;
+    repl->parent = orig->parent;
+
+    for (i = 0; i < 2; i++) {
+        repl->child[i] = orig->child[i];
+        if (repl->child[i]) {
+            repl->child[i]->parent_to_self_ptr = &repl->child[i];
+            repl->child[i]->parent = repl;
+        }
+    }
+
+    *(repl->parent_to_self_ptr) = repl;
+}
+
+void
+radixIntervalTreeInsert(CUradixIntervalTree *tree, CUradixIntervalNode *node, NvU64 start, NvU64 length)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & start) == 0);
+    CU_ASSERT(length > 0 && start + length > start);
+
+    CUradixIntervalNode *parent = NULL;
+    CUradixIntervalNode **parent_to_self_ptr = &tree->root;
+    NvU32 cur_key_bit = tree->key_bits;
+    NvU32 child_to_take = 0;
+
+    memset(node, 0, sizeof(*node));
+    node->start = start;
+    node->end = start + length;
+    node->max_end = node->end;
+    radixIntervalListInit(node);
+
+    while (*parent_to_self_ptr && (*parent_to_self_ptr)->start != start) {
+        CUradixIntervalNode *cur = *parent_to_self_ptr;
+
+        // If the node has a smaller start than the cur node, swap
+        // node<-->cur and try to insert node (now changed) again
+        if (node->start < cur->start) {
+            CUradixIntervalNode *swapNode;
+
+            radixIntervalTreeReplaceNode(cur, node);
+
+            swapNode = cur;
+            cur = node;
+            node = swapNode;
+
+            node->child[0] = NULL;
+            node->child[1] = NULL;
+            node->parent = NULL;
+            node->parent_to_self_ptr = NULL;
+        }
+
+        parent = cur;
+        CU_ASSERT(cur_key_bit > 0);
+        cur_key_bit--;
+        child_to_take = radixIntervalIsBitSet(node->start, cur_key_bit);
+        parent_to_self_ptr = &cur->child[child_to_take];
+    }
+
+    // Swaps only happened on the path above the final position
+    if (*parent_to_self_ptr) {
+        radixIntervalListInsert(node, *parent_to_self_ptr);
+        radixIntervalTreeUpdatePath(*parent_to_self_ptr);
+    }
+    else {
+        node->parent_to_self_ptr = parent_to_self_ptr;
+        *(node->parent_to_self_ptr) = node;
+        node->parent = parent;
+        radixIntervalTreeUpdatePath(node);
+    }
+}
+
+// Removal follows radixTreeRemove: the nodes on the smaller-child chain each
+// move up one position, and the deepest position of the chain is the last
+// one whose subtree changed.
+void
+radixIntervalTreeRemove(CUradixIntervalNode *node)
+{
+    CU_ASSERT(node);
+
+    if (radixIntervalListEmpty(node)) {
+        CUradixIntervalNode **slot = node->parent_to_self_ptr;
+        CUradixIntervalNode *parent = node->parent;
+        CUradixIntervalNode *children[2] = {node->child[0], node->child[1]};
+
+        for (;;) {
+            unsigned childNumber = (children[0]? 0 : 1);
+            CUradixIntervalNode *promoted = children[childNumber];
+            CUradixIntervalNode *sibling = children[1 - childNumber];
+            CUradixIntervalNode *promoted_child[2];
+
+            if (promoted == NULL) {
+                *slot = NULL;
+                break;
+            }
+
+            promoted_child[0] = promoted->child[0];
+            promoted_child[1] = promoted->child[1];
+
+            *slot = promoted;
+            promoted->parent_to_self_ptr = slot;
+            promoted->parent = parent;
+
+            promoted->child[1 - childNumber] = sibling;
+            if (sibling) {
+                sibling->parent_to_self_ptr = &promoted->child[1 - childNumber];
+                sibling->parent = promoted;
+            }
+
+            slot = &promoted->child[childNumber];
+            parent = promoted;
+            children[0] = promoted_child[0];
+            children[1] = promoted_child[1];
+        }
+
+        radixIntervalTreeUpdatePath(parent);
+    }
+    else {
+        CUradixIntervalNode *primary;
+
+        // If this is the first element of the node (i.e., primary element),
+        // another element in the linked-list should step up and become
+        // primary.
+        if (node->parent_to_self_ptr) {
+            primary = node->next;
+            radixIntervalTreeReplaceNode(node, primary);
+            node->parent_to_self_ptr = NULL;
+        }
+        else {
+            primary = node->next;
+            while (primary->parent_to_self_ptr == NULL) {
+                primary = primary->next;
+            }
+        }
+        radixIntervalListRemove(node);
+        radixIntervalTreeUpdatePath(primary);
+    }
+}
+
+// First node of a primary's list ending after first, or NULL
+static CUradixIntervalNode *
+radixIntervalListFindEndAfter(CUradixIntervalNode *node, NvU64 first)
+{
+    CUradixIntervalNode *dup = node;
+
+    do {
+        if (dup->end > first) {
+            return dup;
+        }
+        dup = dup->next;
+    } while (dup != node);
+
+    return NULL;
+}
+
+// Overlap with the inclusive range [first, last]: start <= last and
+// end > first. A subtree can only hold such an interval if its root (the
+// smallest start) is <= last and its max_end is > first.
+//
+// If the root doesn't overlap, at most one child needs to be searched: when
+// child[0] holds some interval ending after first but none that overlaps,
+// that interval starts after last, and so does everything under child[1].
+static CUradixIntervalNode *
+radixIntervalTreeFindFirst(CUradixIntervalTree *tree, NvU64 first, NvU64 last)
+{
+    CUradixIntervalNode *node = tree->root;
+
+    while (node && node->max_end > first && node->start <= last) {
+        CUradixIntervalNode *found = radixIntervalListFindEndAfter(node, first);
+        if (found) {
+            return found;
+        }
+
+        if (node->child[0] && node->child[0]->max_end > first) {
+            node = node->child[0];
+        }
+        else {
+            node = node->child[1];
+        }
+    }
+
+    return NULL;
+}
+
+// Inclusive last address of [start, start + length), saturating at the top
+// of the address space
+static inline NvU64
+radixIntervalLast(NvU64 start, NvU64 length)
+{
+    CU_ASSERT(length > 0);
+    return (start + (length - 1) < start)? ~0ULL : start + (length - 1);
+}
+
+CUradixIntervalNode *
+radixIntervalTreeFindOverlap(CUradixIntervalTree *tree, NvU64 start, NvU64 length)
+{
+    CU_ASSERT(tree);
+    return radixIntervalTreeFindFirst(tree, start, radixIntervalLast(start, length));
+}
+
+CUradixIntervalNode *
+radixIntervalTreeFindContaining(CUradixIntervalTree *tree, NvU64 address)
+{
+    CU_ASSERT(tree);
+    return radixIntervalTreeFindFirst(tree, address, address);
+}
+
+// A pre-order walk visits starts in ascending order, since a parent is
+// smaller than its subtree and child[0] keys are smaller than child[1] keys.
+// At most one pending child[1] per level sits on the stack.
+int
+radixIntervalTreeForEachOverlap(CUradixIntervalTree *tree, NvU64 start, NvU64 length,
+                                CUradixIntervalVisit visit, void *data)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(visit);
+
+    CUradixIntervalNode *stack[64 + 2];
+    int depth = 0;
+    NvU64 first = start;
+    NvU64 last = radixIntervalLast(start, length);
+
+    if (tree->root) {
+        stack[depth++] = tree->root;
+    }
+
+    while (depth > 0) {
+        CUradixIntervalNode *node = stack[--depth];
+        CUradixIntervalNode *dup = node;
+
+        if (node->max_end <= first || node->start > last) {
+            continue;
+        }
+
+        do {
+            if (dup->end > first) {
+                int result = visit(dup, data);
+                if (result) {
+                    return result;
+                }
+            }
+            dup = dup->next;
+        } while (dup != node);
+
+        if (node->child[1]) {
+            stack[depth++] = node->child[1];
+        }
+        if (node->child[0]) {
+            stack[depth++] = node->child[0];
+        }
+    }
+
+    return 0;
+}
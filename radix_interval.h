@@ -0,0 +1,74 @@
+#ifndef __RADIX_INTERVAL_H__
+#define __RADIX_INTERVAL_H__
+
+#include "utils_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct CUradixIntervalNode_st CUradixIntervalNode;
+typedef struct CUradixIntervalTree_st CUradixIntervalTree;
+
+// Interval variant of CUradixNode: the start address is the radix key and
+// every primary node also tracks the largest end address in its subtree
+// (including its own duplicate list), which lets overlap queries skip whole
+// subtrees.
+struct CUradixIntervalNode_st
+{
+    struct CUradixIntervalNode_st *next;
+    struct CUradixIntervalNode_st *prev;
+
+    struct CUradixIntervalNode_st *child[2];
+    struct CUradixIntervalNode_st **parent_to_self_ptr;
+    struct CUradixIntervalNode_st *parent;
+
+    NvU64 start;   // Bits of the start determine the location of a node
+    NvU64 end;     // Exclusive end, start + length
+    NvU64 max_end; // Largest end in the subtree; only valid on primary nodes
+};
+
+struct CUradixIntervalTree_st
+{
+    struct CUradixIntervalNode_st *root;
+    unsigned int key_bits;
+};
+
+// Visitor for radixIntervalTreeForEachOverlap; a non-zero return stops the
+// iteration and is returned to the caller.
+typedef int (*CUradixIntervalVisit)(CUradixIntervalNode *node, void *data);
+
+CUDA_TEST_EXPORT void
+radixIntervalTreeInit(CUradixIntervalTree *tree, NvU32 key_bits);
+
+// Inserts [start, start + length). length must be non-zero and the end must
+// not wrap around. Intervals with equal starts are kept on a duplicate list.
+CUDA_TEST_EXPORT void
+radixIntervalTreeInsert(CUradixIntervalTree *tree, CUradixIntervalNode *node, NvU64 start, NvU64 length);
+
+CUDA_TEST_EXPORT void
+radixIntervalTreeRemove(CUradixIntervalNode *node);
+
+CUDA_TEST_EXPORT NvBool
+radixIntervalTreeEmpty(CUradixIntervalTree *tree);
+
+// Returns the interval with the lowest start that overlaps
+// [start, start + length), or NULL. Walks a single root-to-leaf path.
+CUDA_TEST_EXPORT CUradixIntervalNode *
+radixIntervalTreeFindOverlap(CUradixIntervalTree *tree, NvU64 start, NvU64 length);
+
+// Stabbing query: the interval with the lowest start containing address.
+CUDA_TEST_EXPORT CUradixIntervalNode *
+radixIntervalTreeFindContaining(CUradixIntervalTree *tree, NvU64 address);
+
+// Calls visit for every interval overlapping [start, start + length), in
+// ascending start order.
+CUDA_TEST_EXPORT int
+radixIntervalTreeForEachOverlap(CUradixIntervalTree *tree, NvU64 start, NvU64 length,
+                                CUradixIntervalVisit visit, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -210,27 +210,64 @@ struct WideRadixTree {
     ObjectPool leafPool;
 };
 
+// Subtree counters of the 64 nodes in a non-leaf block live in a side array
+// right after the nodes, so the node layout is the same with or without them
+static inline uint64_t *treeChildCounts(void *block, uint64_t child) {
+    return (uint64_t *)((char *)block + 64 * sizeof(WideRadixNode)) + (child << 2);
+}
+
+static inline void *treeLeafSlot(WideRadixTree *tree, void *block, uint64_t child) {
+    return (char *)block + child * tree->leafSlotSize;
+}
+
 void treeInit(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align) {
+    treeInitWithFlags(tree, log2Max, log2Align, 0);
+}
+
+void treeInitWithFlags(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align, uint32_t flags) {
+    treeInitWithValueSize(tree, log2Max, log2Align, sizeof(uint64_t), flags);
+}
+
+int treeInitWithValueSize(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align, uint32_t valueSize, uint32_t flags) {
+    if (!tree || valueSize < sizeof(uint64_t) || (valueSize % sizeof(uint64_t)) != 0) {
+        return -1;
+    }
+    if ((flags & TREE_FLAG_MULTI) && valueSize != sizeof(uint64_t)) {
+        return -1;  // Multimap slots hold uint64_t values only
+    }
+    
     memset(&tree->root, 0, sizeof(tree->root));
+    memset(tree->rootCounts, 0, sizeof(tree->rootCounts));
     tree->numLevels = ((log2Max - log2Align) + 7) >> 3;
+    tree->flags = flags;
+    tree->leafSlotSize = (flags & TREE_FLAG_MULTI) ? sizeof(WideRadixMultiSlot) : valueSize;
     
     // Use smaller initial pool sizes since we can now grow dynamically
     size_t nonLeafPoolSize = 64 * sizeof(WideRadixNode);
+    if (flags & TREE_FLAG_COUNTS) {
+        nonLeafPoolSize += 64 * sizeof(tree->rootCounts);
+    }
     objectPoolInit(&tree->nonLeafPool, nonLeafPoolSize, 100);  // Start with 100 non-leaf nodes
     
-    size_t leafPoolSize = 64 * sizeof(uint64_t);
+    size_t leafPoolSize = 64 * tree->leafSlotSize;
     objectPoolInit(&tree->leafPool, leafPoolSize, 1000);  // Start with 1000 leaf values
+    
+    memset(&tree->overflowPool, 0, sizeof(tree->overflowPool));
+    if (flags & TREE_FLAG_MULTI) {
+        objectPoolInit(&tree->overflowPool, sizeof(WideRadixValueChunk), 1000);
+    }
+    return 0;
 }
 
 uint64_t treeRemove(WideRadixTree *tree, uint64_t key);
 
-int treeInsertOrReturnExisting(WideRadixTree *tree, uint64_t key, uint64_t value, uint64_t *existing) {
-    if (!tree || !existing) {
-        return -1;
-    }
-    
+// Walks down to the leaf slot of key, allocating blocks on the way, and marks
+// the key present. *isNew tells whether the key was absent before.
+static inline int treeInsertSlot(WideRadixTree *tree, uint64_t key, void **slot, bool *isNew) {
     WideRadixNode *node = &tree->root;
-    *existing = 0;
+    uint64_t *counts = tree->rootCounts;
+    uint64_t *pathCounts[8];
+    uint8_t pathIdx[8];
     for (uint8_t level = 0; level < tree->numLevels; level++) {
         uint8_t keyLevelBits = (uint8_t)((key >> ((tree->numLevels - level - 1) << 3)) & 0xFF);
         uint8_t keyLevelIdx = keyLevelBits >> 6;
@@ -253,23 +290,133 @@ int treeInsertOrReturnExisting(WideRadixTree *tree, uint64_t key, uint64_t value
             return -1;
         }
         
-        node->bits[keyLevelIdx] |= 1ULL << keyLevelChild;
+        pathCounts[level] = counts;
+        pathIdx[level] = keyLevelIdx;
         if (isLastLevel) {
             // Additional safety check before accessing the array
             if (keyLevelChild >= 64) {
                 return -1;  // Safety check
             }
-            *existing = ((uint64_t *)node->children[keyLevelIdx])[keyLevelChild];
-            if (*existing == 0) {
-                ((uint64_t *)node->children[keyLevelIdx])[keyLevelChild] = value;
+            *isNew = !(node->bits[keyLevelIdx] & (1ULL << keyLevelChild));
+            node->bits[keyLevelIdx] |= 1ULL << keyLevelChild;
+            *slot = treeLeafSlot(tree, node->children[keyLevelIdx], keyLevelChild);
+            if (*isNew && (tree->flags & TREE_FLAG_COUNTS)) {
+                for (uint8_t l = 0; l <= level; l++) {
+                    pathCounts[l][pathIdx[l]]++;
+                }
             }
             return 0;
         }
+        node->bits[keyLevelIdx] |= 1ULL << keyLevelChild;
+        if (tree->flags & TREE_FLAG_COUNTS) {
+            counts = treeChildCounts(node->children[keyLevelIdx], keyLevelChild);
+        }
         node = &((WideRadixNode*)node->children[keyLevelIdx])[keyLevelChild];
     }
+    return -1;
+}
+
+int treeInsertOrReturnExisting(WideRadixTree *tree, uint64_t key, uint64_t value, uint64_t *existing) {
+    if (!tree || !existing) {
+        return -1;
+    }
+    
+    void *slot;
+    bool isNew;
+    *existing = 0;
+    if (treeInsertSlot(tree, key, &slot, &isNew) != 0) {
+        return -1;
+    }
+    
+    if (tree->flags & TREE_FLAG_MULTI) {
+        WideRadixMultiSlot *multi = (WideRadixMultiSlot *)slot;
+        if (isNew) {
+            multi->values[0] = value;
+            multi->count = 1;
+        } else {
+            *existing = multi->values[0];
+        }
+        return 0;
+    }
+    
+    *existing = *(uint64_t *)slot;
+    if (*existing == 0) {
+        *(uint64_t *)slot = value;
+    }
     return 0;
 }
 
+// Returns the location of the i-th value of a multimap slot. Values past the
+// inline ones fill chunks oldest-first; the chain is linked newest-first.
+static inline uint64_t *treeMultiValueAt(WideRadixMultiSlot *slot, uint64_t i) {
+    if (i < TREE_MULTI_INLINE_VALUES) {
+        return &slot->values[i];
+    }
+    uint64_t numChunks = (slot->count - TREE_MULTI_INLINE_VALUES + TREE_MULTI_CHUNK_VALUES - 1) / TREE_MULTI_CHUNK_VALUES;
+    uint64_t chunkIdx = (i - TREE_MULTI_INLINE_VALUES) / TREE_MULTI_CHUNK_VALUES;
+    WideRadixValueChunk *chunk = slot->overflow;
+    for (uint64_t skip = numChunks - 1 - chunkIdx; skip > 0; skip--) {
+        chunk = chunk->next;
+    }
+    return &chunk->values[(i - TREE_MULTI_INLINE_VALUES) % TREE_MULTI_CHUNK_VALUES];
+}
+
+static int treeMultiPush(WideRadixTree *tree, WideRadixMultiSlot *slot, uint64_t value) {
+    if (slot->count < TREE_MULTI_INLINE_VALUES) {
+        slot->values[slot->count++] = value;
+        return 0;
+    }
+    uint64_t pos = (slot->count - TREE_MULTI_INLINE_VALUES) % TREE_MULTI_CHUNK_VALUES;
+    if (pos == 0) {
+        void *chunk;
+        if (objectPoolAlloc(&tree->overflowPool, &chunk) == NULL) {
+            return -1;
+        }
+        ((WideRadixValueChunk *)chunk)->next = slot->overflow;
+        slot->overflow = (WideRadixValueChunk *)chunk;
+    }
+    slot->overflow->values[pos] = value;
+    slot->count++;
+    return 0;
+}
+
+// Removes and returns the most recently added value; count must be > 1
+static uint64_t treeMultiPop(WideRadixTree *tree, WideRadixMultiSlot *slot) {
+    uint64_t last = slot->count - 1;
+    if (last < TREE_MULTI_INLINE_VALUES) {
+        slot->count--;
+        return slot->values[last];
+    }
+    uint64_t pos = (last - TREE_MULTI_INLINE_VALUES) % TREE_MULTI_CHUNK_VALUES;
+    WideRadixValueChunk *head = slot->overflow;
+    uint64_t value = head->values[pos];
+    if (pos == 0) {
+        slot->overflow = head->next;
+        objectPoolFree(&tree->overflowPool, head);
+    }
+    slot->count--;
+    return value;
+}
+
+int treeInsertDuplicate(WideRadixTree *tree, uint64_t key, uint64_t value) {
+    if (!tree || !(tree->flags & TREE_FLAG_MULTI)) {
+        return -1;
+    }
+    
+    void *slot;
+    bool isNew;
+    if (treeInsertSlot(tree, key, &slot, &isNew) != 0) {
+        return -1;
+    }
+    
+    WideRadixMultiSlot *multi = (WideRadixMultiSlot *)slot;
+    if (isNew) {
+        multi->values[0] = value;
+        multi->count = 1;
+        return 0;
+    }
+    return treeMultiPush(tree, multi, value);
+}
 
 #if 1
 static inline uint64_t getFirstSetBit(uint64_t val) {
@@ -337,14 +484,15 @@ uint64_t treeFind(WideRadixTree *tree, uint64_t key) {
         }
         
         if (level == lastLevel) {
-            return ((uint64_t*)node->children[keyLevelIdx])[keyLevelChild];
+            return *(uint64_t *)treeLeafSlot(tree, node->children[keyLevelIdx], keyLevelChild);
         }
         node = &((WideRadixNode*)node->children[keyLevelIdx])[keyLevelChild];
     }
     return 0;
 }
 
-uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
+// Returns the leaf slot of the smallest key >= key, or NULL if none exists
+static void *treeFindGEQSlot(WideRadixTree *tree, uint64_t key) {
     uint8_t keyLevel[8], idx, child;
     WideRadixNode *nodes[8];
     uint8_t lastLevel = tree->numLevels - 1, level;
@@ -355,7 +503,7 @@ uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
         idx = keyLevel[level] >> 6, child = keyLevel[level] & 0x3F;
         
         if (idx >= 4) {
-            return 0;  // Safety check
+            return NULL;  // Safety check
         }
         
         if (!(nodes[level]->bits[idx] & (1ULL << child))) {
@@ -363,11 +511,11 @@ uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
         }
         
         if (nodes[level]->children[idx] == NULL) {
-            return 0;  // Safety check
+            return NULL;  // Safety check
         }
         
         if (level == lastLevel) {
-            return ((uint64_t*)nodes[level]->children[idx])[child];
+            return treeLeafSlot(tree, nodes[level]->children[idx], child);
         }
         nodes[level + 1] = &((WideRadixNode*)nodes[level]->children[idx])[child];
     }
@@ -375,7 +523,7 @@ uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
     uint64_t firstSetBit;
     while ((firstSetBit = getFirstSetBitInRange(nodes[level]->bits, keyLevel[level]+(uint64_t)(1), 255)) > 255) {
         if (level == 0) {
-            return 0;
+            return NULL;
         }
         level--;
     };
@@ -383,66 +531,307 @@ uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
     for (; level < tree->numLevels; level++) {
         idx = firstSetBit >> 6, child = firstSetBit & 0x3F;
         if (level == lastLevel) {
-            return ((uint64_t*)nodes[level]->children[idx])[child];
+            return treeLeafSlot(tree, nodes[level]->children[idx], child);
         }
         nodes[level + 1] = &((WideRadixNode*)nodes[level]->children[idx])[child];
         firstSetBit = getFirstSetBitInRange(nodes[level+1]->bits, 0, 255);
     }
 
-    return 0;
+    return NULL;
 }
 
-uint64_t treeRemove(WideRadixTree *tree, uint64_t key) {
+uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key) {
+    void *slot = treeFindGEQSlot(tree, key);
+    return slot ? *(uint64_t *)slot : 0;
+}
+
+// Removes key and copies up to removedSize bytes of its slot to removed.
+// In multimap mode only the most recent value is removed while others remain.
+// Returns -1 if the key is not present.
+static int treeRemoveSlot(WideRadixTree *tree, uint64_t key, void *removed, size_t removedSize) {
     uint8_t keyLevelIdx[8], keyLevelChild[8];
     WideRadixNode *nodes[8];
+    uint64_t *counts[8];
     uint8_t lastLevel = tree->numLevels - 1;
-    uint64_t value = 0;
 
     getKeyLevelBits(key, tree->numLevels, keyLevelIdx, keyLevelChild);
 
     nodes[0] = &tree->root;
-    for (uint8_t level = 0; level < lastLevel; level++) {
+    counts[0] = tree->rootCounts;
+    for (uint8_t level = 0; level <= lastLevel; level++) {
         if (keyLevelIdx[level] >= 4) {
-            return 0;  // Safety check
+            return -1;  // Safety check
         }
         
-        if (nodes[level]->children[keyLevelIdx[level]] == NULL) {
-            lastLevel = level;
-            break;
+        if (!(nodes[level]->bits[keyLevelIdx[level]] & (1ULL << keyLevelChild[level]))) {
+            return -1;  // Key not present
+        }
+        if (level < lastLevel) {
+            nodes[level+1] = &((WideRadixNode*)nodes[level]->children[keyLevelIdx[level]])[keyLevelChild[level]];
+            if (tree->flags & TREE_FLAG_COUNTS) {
+                counts[level+1] = treeChildCounts(nodes[level]->children[keyLevelIdx[level]], keyLevelChild[level]);
+            }
         }
-        nodes[level+1] = &((WideRadixNode*)nodes[level]->children[keyLevelIdx[level]])[keyLevelChild[level]];
     }
 
-    if ((lastLevel == (tree->numLevels-1)) && (nodes[lastLevel]->children[keyLevelIdx[lastLevel]])) {
-        if (keyLevelIdx[lastLevel] >= 4) {
-            return 0;  // Safety check
+    void *slot = treeLeafSlot(tree, nodes[lastLevel]->children[keyLevelIdx[lastLevel]], keyLevelChild[lastLevel]);
+    if ((tree->flags & TREE_FLAG_MULTI) && ((WideRadixMultiSlot *)slot)->count > 1) {
+        uint64_t value = treeMultiPop(tree, (WideRadixMultiSlot *)slot);
+        if (removed) {
+            memcpy(removed, &value, removedSize < sizeof(value) ? removedSize : sizeof(value));
         }
-        value = ((uint64_t*)nodes[lastLevel]->children[keyLevelIdx[lastLevel]])[keyLevelChild[lastLevel]];
-        ((uint64_t*)nodes[lastLevel]->children[keyLevelIdx[lastLevel]])[keyLevelChild[lastLevel]] = 0;
+        return 0;
     }
+    if (removed) {
+        memcpy(removed, slot, removedSize < tree->leafSlotSize ? removedSize : tree->leafSlotSize);
+    }
+    memset(slot, 0, tree->leafSlotSize);
 
-    for (uint8_t level = lastLevel; level > 0; level--) {
-        if (keyLevelIdx[level] >= 4) {
-            continue;  // Safety check
+    if (tree->flags & TREE_FLAG_COUNTS) {
+        for (uint8_t level = 0; level <= lastLevel; level++) {
+            counts[level][keyLevelIdx[level]]--;
         }
-        
+    }
+
+    // Clear the path bottom-up, including the root, until a node stays non-empty
+    for (uint8_t level = lastLevel; ; level--) {
         nodes[level]->bits[keyLevelIdx[level]] &= ~(1ULL << keyLevelChild[level]);
         if (!nodes[level]->bits[keyLevelIdx[level]] && nodes[level]->children[keyLevelIdx[level]]) {
             objectPoolFree((level == (tree->numLevels - 1)) ? &tree->leafPool : &tree->nonLeafPool, nodes[level]->children[keyLevelIdx[level]]);
             nodes[level]->children[keyLevelIdx[level]] = NULL;
         }
-        if (nodes[level]->bits[0] || nodes[level]->bits[1] || nodes[level]->bits[2] || nodes[level]->bits[3]) {
+        if (level == 0 || nodes[level]->bits[0] || nodes[level]->bits[1] || nodes[level]->bits[2] || nodes[level]->bits[3]) {
             break;
         }
     }
 
+    return 0;
+}
+
+uint64_t treeRemove(WideRadixTree *tree, uint64_t key) {
+    uint64_t value = 0;
+    treeRemoveSlot(tree, key, &value, sizeof(value));
     return value;
 }
 
+// Sum of the subtree counts of the children of node selected by mask (a
+// subset of node->bits[idx]). Walks whichever side of the word has fewer
+// children, so at most 32 counters are read per level.
+static inline uint64_t treeSumChildCounts(WideRadixNode *node, uint64_t *counts, uint8_t idx, uint64_t mask) {
+    uint64_t sum = 0, total = 0;
+    if (__builtin_popcountll(mask) > 32) {
+        total = counts[idx];
+        mask = node->bits[idx] & ~mask;
+    }
+    while (mask) {
+        uint64_t *childCounts = treeChildCounts(node->children[idx], getFirstSetBit(mask));
+        sum += childCounts[0] + childCounts[1] + childCounts[2] + childCounts[3];
+        mask &= mask - 1;
+    }
+    return total ? total - sum : sum;
+}
+
+uint64_t treeCount(WideRadixTree *tree) {
+    if (!tree || !(tree->flags & TREE_FLAG_COUNTS)) {
+        return 0;
+    }
+    return tree->rootCounts[0] + tree->rootCounts[1] + tree->rootCounts[2] + tree->rootCounts[3];
+}
+
+uint64_t treeRank(WideRadixTree *tree, uint64_t key) {
+    if (!tree || !(tree->flags & TREE_FLAG_COUNTS)) {
+        return 0;
+    }
+    if (tree->numLevels < 8 && (key >> (tree->numLevels << 3)) != 0) {
+        return treeCount(tree);  // Key is above every storable key
+    }
+
+    WideRadixNode *node = &tree->root;
+    uint64_t *counts = tree->rootCounts;
+    uint8_t lastLevel = tree->numLevels - 1;
+    uint64_t rank = 0;
+    for (uint8_t level = 0; ; level++) {
+        uint8_t keyLevelBits = (uint8_t)((key >> ((lastLevel - level) << 3)) & 0xFF);
+        uint8_t keyLevelIdx = keyLevelBits >> 6;
+        uint8_t keyLevelChild = keyLevelBits & 0x3F;
+        uint64_t below = node->bits[keyLevelIdx] & ((1ULL << keyLevelChild) - 1);
+
+        for (uint8_t idx = 0; idx < keyLevelIdx; idx++) {
+            rank += counts[idx];
+        }
+        if (level == lastLevel) {
+            return rank + __builtin_popcountll(below);
+        }
+        rank += treeSumChildCounts(node, counts, keyLevelIdx, below);
+        if (!(node->bits[keyLevelIdx] & (1ULL << keyLevelChild))) {
+            return rank;
+        }
+        counts = treeChildCounts(node->children[keyLevelIdx], keyLevelChild);
+        node = &((WideRadixNode*)node->children[keyLevelIdx])[keyLevelChild];
+    }
+}
+
+uint64_t treeCountRange(WideRadixTree *tree, uint64_t lo, uint64_t hi) {
+    if (hi <= lo) {
+        return 0;
+    }
+    return treeRank(tree, hi) - treeRank(tree, lo);
+}
+
+int treeSelect(WideRadixTree *tree, uint64_t k, uint64_t *key) {
+    if (!tree || !key || !(tree->flags & TREE_FLAG_COUNTS)) {
+        return -1;
+    }
+
+    WideRadixNode *node = &tree->root;
+    uint64_t *counts = tree->rootCounts;
+    uint8_t lastLevel = tree->numLevels - 1;
+    uint64_t result = 0;
+    for (uint8_t level = 0; ; level++) {
+        uint8_t idx;
+        for (idx = 0; idx < 4 && k >= counts[idx]; idx++) {
+            k -= counts[idx];
+        }
+        if (idx == 4) {
+            return -1;  // Fewer than k+1 keys in the tree
+        }
+
+        uint64_t word = node->bits[idx];
+        uint64_t child;
+        if (level == lastLevel) {
+            for (; k > 0; k--) {
+                word &= word - 1;
+            }
+            *key = (result << 8) | ((uint64_t)idx << 6) | getFirstSetBit(word);
+            return 0;
+        }
+        for (;;) {
+            child = getFirstSetBit(word);
+            uint64_t *childCounts = treeChildCounts(node->children[idx], child);
+            uint64_t total = childCounts[0] + childCounts[1] + childCounts[2] + childCounts[3];
+            if (k < total) {
+                counts = childCounts;
+                break;
+            }
+            k -= total;
+            word &= word - 1;
+        }
+        result = (result << 8) | ((uint64_t)idx << 6) | child;
+        node = &((WideRadixNode*)node->children[idx])[child];
+    }
+}
+
+// Returns the leaf slot of key, or NULL if the key is not present
+static void *treeFindSlot(WideRadixTree *tree, uint64_t key) {
+    WideRadixNode *node = &tree->root;
+    uint8_t lastLevel = tree->numLevels - 1;
+    for (uint8_t level = 0; ; level++) {
+        uint8_t keyLevelBits = (uint8_t)((key >> ((lastLevel - level) << 3)) & 0xFF);
+        uint8_t keyLevelIdx = keyLevelBits >> 6;
+        uint8_t keyLevelChild = keyLevelBits & 0x3F;
+        
+        if (!(node->bits[keyLevelIdx] & (1ULL << keyLevelChild))) {
+            return NULL;
+        }
+        if (level == lastLevel) {
+            return treeLeafSlot(tree, node->children[keyLevelIdx], keyLevelChild);
+        }
+        node = &((WideRadixNode*)node->children[keyLevelIdx])[keyLevelChild];
+    }
+}
+
+int treeRemoveValue(WideRadixTree *tree, uint64_t key, uint64_t value) {
+    if (!tree || !(tree->flags & TREE_FLAG_MULTI)) {
+        return -1;
+    }
+    
+    WideRadixMultiSlot *slot = (WideRadixMultiSlot *)treeFindSlot(tree, key);
+    if (!slot) {
+        return -1;
+    }
+    
+    for (uint64_t i = 0; i < slot->count; i++) {
+        uint64_t *location = treeMultiValueAt(slot, i);
+        if (*location != value) {
+            continue;
+        }
+        if (slot->count == 1) {
+            treeRemove(tree, key);
+        } else {
+            // Fill the hole with the most recent value
+            uint64_t last = treeMultiPop(tree, slot);
+            if (i < slot->count) {
+                *location = last;
+            }
+        }
+        return 0;
+    }
+    return -1;
+}
+
+size_t treeFindAll(WideRadixTree *tree, uint64_t key, uint64_t *values, size_t maxValues) {
+    if (!tree || !(tree->flags & TREE_FLAG_MULTI)) {
+        return 0;
+    }
+    
+    WideRadixMultiSlot *slot = (WideRadixMultiSlot *)treeFindSlot(tree, key);
+    if (!slot) {
+        return 0;
+    }
+    
+    size_t copied = 0;
+    for (uint64_t i = 0; i < slot->count && i < TREE_MULTI_INLINE_VALUES && copied < maxValues; i++) {
+        values[copied++] = slot->values[i];
+    }
+    
+    // The head chunk is the only partially filled one
+    uint64_t inHead = (slot->count > TREE_MULTI_INLINE_VALUES) ?
+                      ((slot->count - TREE_MULTI_INLINE_VALUES - 1) % TREE_MULTI_CHUNK_VALUES) + 1 : 0;
+    for (WideRadixValueChunk *chunk = slot->overflow; chunk && copied < maxValues; chunk = chunk->next) {
+        uint64_t inChunk = (chunk == slot->overflow) ? inHead : TREE_MULTI_CHUNK_VALUES;
+        for (uint64_t i = 0; i < inChunk && copied < maxValues; i++) {
+            values[copied++] = chunk->values[i];
+        }
+    }
+    return slot->count;
+}
+
+int treeInsertPayload(WideRadixTree *tree, uint64_t key, const void *payload, void **slot) {
+    if (!tree || !payload || !slot || (tree->flags & TREE_FLAG_MULTI)) {
+        return -1;
+    }
+    
+    bool isNew;
+    if (treeInsertSlot(tree, key, slot, &isNew) != 0) {
+        return -1;
+    }
+    if (!isNew) {
+        return 1;
+    }
+    memcpy(*slot, payload, tree->leafSlotSize);
+    return 0;
+}
+
+void *treeFindPayload(WideRadixTree *tree, uint64_t key) {
+    return tree ? treeFindSlot(tree, key) : NULL;
+}
+
+void *treeFindGEQPayload(WideRadixTree *tree, uint64_t key) {
+    return tree ? treeFindGEQSlot(tree, key) : NULL;
+}
+
+int treeRemovePayload(WideRadixTree *tree, uint64_t key, void *payload) {
+    if (!tree || (tree->flags & TREE_FLAG_MULTI)) {
+        return -1;
+    }
+    return treeRemoveSlot(tree, key, payload, payload ? tree->leafSlotSize : 0);
+}
+
 void treeDestroy(WideRadixTree *tree) {
     if (tree) {
         objectPoolDestroy(&tree->nonLeafPool);
         objectPoolDestroy(&tree->leafPool);
+        objectPoolDestroy(&tree->overflowPool);
         memset(tree, 0, sizeof(*tree));
     }
 }
\ No newline at end of file
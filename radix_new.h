@@ -35,19 +35,79 @@ typedef struct WideRadixNode_st {
     void* children[4];
 } WideRadixNode;
 
+// treeInitWithFlags() flags
+#define TREE_FLAG_COUNTS 0x1  // Maintain per-subtree key counts for rank/select
+#define TREE_FLAG_MULTI  0x2  // Allow several values per key (multimap)
+
+#define TREE_MULTI_INLINE_VALUES 2
+#define TREE_MULTI_CHUNK_VALUES  7
+
+// Overflow storage for keys holding more than TREE_MULTI_INLINE_VALUES values.
+// The chain head is the most recently filled chunk.
+typedef struct WideRadixValueChunk_st {
+    uint64_t values[TREE_MULTI_CHUNK_VALUES];
+    struct WideRadixValueChunk_st *next;
+} WideRadixValueChunk;
+
+// Leaf slot of a TREE_FLAG_MULTI tree. The first value sits at offset 0, so
+// lookups read it exactly like a plain uint64_t leaf.
+typedef struct WideRadixMultiSlot_st {
+    uint64_t values[TREE_MULTI_INLINE_VALUES];
+    uint64_t count;                  // Total number of values for this key
+    WideRadixValueChunk *overflow;
+} WideRadixMultiSlot;
+
 typedef struct WideRadixTree_st {
     WideRadixNode root;
     uint8_t numLevels;
+    uint32_t flags;
+    uint32_t leafSlotSize;    // Bytes per key in leaf blocks
+    uint64_t rootCounts[4];   // Keys below each word of root.bits (TREE_FLAG_COUNTS only)
     ObjectPool nonLeafPool;
     ObjectPool leafPool;
+    ObjectPool overflowPool;  // WideRadixValueChunk (TREE_FLAG_MULTI only)
 } WideRadixTree;
 
 // Function declarations for the radix tree
 void treeInit(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align);
+void treeInitWithFlags(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align, uint32_t flags);
+// Stores valueSize bytes (a non-zero multiple of 8) inline per key, so a leaf
+// block is 64 * valueSize bytes. Returns -1 on invalid arguments.
+int treeInitWithValueSize(WideRadixTree *tree, uint8_t log2Max, uint8_t log2Align, uint32_t valueSize, uint32_t flags);
 int treeInsertOrReturnExisting(WideRadixTree *tree, uint64_t key, uint64_t value, uint64_t *existing);
 uint64_t treeFind(WideRadixTree *tree, uint64_t key);
 uint64_t treeFindGEQ(WideRadixTree *tree, uint64_t key);
 uint64_t treeRemove(WideRadixTree *tree, uint64_t key);
+
+// Order statistics, available when the tree was initialized with
+// TREE_FLAG_COUNTS. treeRank returns the number of keys < key,
+// treeCountRange the number of keys in [lo, hi), and treeSelect stores the
+// k-th smallest key (0-based) in *key, returning -1 if k is out of range.
+uint64_t treeCount(WideRadixTree *tree);
+uint64_t treeRank(WideRadixTree *tree, uint64_t key);
+uint64_t treeCountRange(WideRadixTree *tree, uint64_t lo, uint64_t hi);
+int treeSelect(WideRadixTree *tree, uint64_t k, uint64_t *key);
+
+// Inline payload operations for trees created with treeInitWithValueSize.
+// treeInsertPayload copies the payload and returns 0 for a new key, or
+// returns 1 and leaves the payload untouched if the key exists; either way
+// *slot points to the stored payload. treeFind/treeFindGEQ return the first
+// 8 bytes of a payload.
+int treeInsertPayload(WideRadixTree *tree, uint64_t key, const void *payload, void **slot);
+void *treeFindPayload(WideRadixTree *tree, uint64_t key);
+void *treeFindGEQPayload(WideRadixTree *tree, uint64_t key);
+int treeRemovePayload(WideRadixTree *tree, uint64_t key, void *payload);
+
+// Multimap operations, available when the tree was initialized with
+// TREE_FLAG_MULTI. In that mode treeFind/treeFindGEQ return the first value
+// of a key and treeRemove removes (and returns) its most recently added
+// value, deleting the key with its last value. Counters of TREE_FLAG_COUNTS
+// count distinct keys.
+int treeInsertDuplicate(WideRadixTree *tree, uint64_t key, uint64_t value);
+int treeRemoveValue(WideRadixTree *tree, uint64_t key, uint64_t value);
+// Copies up to maxValues values of key, in no particular order, and returns
+// the total number of values stored for it.
+size_t treeFindAll(WideRadixTree *tree, uint64_t key, uint64_t *values, size_t maxValues);
 void treeDestroy(WideRadixTree *tree);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,283 @@
+#ifndef _RADIX_NEW_HPP
+#define _RADIX_NEW_HPP
+
+// Header-only C++17 counterpart of the WideRadixTree in radix_new.c.
+//
+// The node layout is the same bitmap design: every node carries one presence
+// word per group of 64 children and one pointer per word to a pooled block of
+// child nodes (or leaf values at the last level). Unlike the C version, the
+// key width and the stride are template parameters, so the number of levels
+// and every per-level shift are compile-time constants and the traversal in
+// find()/insertOrReturnExisting() is fully unrolled by the compiler. Leaf
+// values are stored inline in the leaf blocks, and presence at the last level
+// is tracked by the bitmap, so a value of 0 is a valid value.
+//
+// Blocks are allocated from the same ObjectPool used by radix_new.c.
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+extern "C" {
+#include "radix_new.h"
+}
+
+template <unsigned KeyBits, unsigned StrideBits, typename Value>
+class WideRadix {
+    static_assert(KeyBits >= 1 && KeyBits <= 64, "KeyBits must be in [1, 64]");
+    static_assert(StrideBits >= 1 && StrideBits <= 8, "StrideBits must be in [1, 8]");
+    static_assert(std::is_trivially_copyable<Value>::value, "Value must be trivially copyable");
+
+public:
+    static constexpr unsigned kFanout = 1u << StrideBits;
+    static constexpr unsigned kChildBits = StrideBits < 6 ? StrideBits : 6;
+    static constexpr unsigned kBlockSize = 1u << kChildBits;   // children per presence word
+    static constexpr unsigned kNumWords = kFanout / kBlockSize;
+    static constexpr unsigned kNumLevels = (KeyBits + StrideBits - 1) / StrideBits;
+
+    struct Node {
+        uint64_t bits[kNumWords];
+        void* children[kNumWords];
+    };
+
+    WideRadix() {
+        memset(&root, 0, sizeof(root));
+        // Same initial pool sizes as treeInit(); the pools grow on demand
+        objectPoolInit(&nonLeafPool, kBlockSize * sizeof(Node), 100);
+        objectPoolInit(&leafPool, kBlockSize * sizeof(Value), 1000);
+    }
+
+    ~WideRadix() {
+        objectPoolDestroy(&nonLeafPool);
+        objectPoolDestroy(&leafPool);
+    }
+
+    WideRadix(const WideRadix&) = delete;
+    WideRadix& operator=(const WideRadix&) = delete;
+
+    // Returns 0 on success and -1 on failure. If the key is already present
+    // its value is left untouched and *existing points to it, otherwise
+    // *existing is set to nullptr.
+    int insertOrReturnExisting(uint64_t key, const Value& value, Value** existing) {
+        if (!existing || !keyInRange(key)) {
+            return -1;
+        }
+        *existing = nullptr;
+        return insertAt<0>(&root, key, value, existing);
+    }
+
+    Value* find(uint64_t key) {
+        if (!keyInRange(key)) {
+            return nullptr;
+        }
+        return findAt<0>(&root, key);
+    }
+
+    // Returns the value of the smallest key >= key, or nullptr if none exists.
+    // If foundKey is given it receives that key.
+    Value* findGEQ(uint64_t key, uint64_t* foundKey = nullptr) {
+        if (!keyInRange(key)) {
+            return nullptr;
+        }
+
+        Node* nodes[kNumLevels];
+        unsigned digits[kNumLevels];
+        unsigned level;
+
+        nodes[0] = &root;
+        for (level = 0; level < kNumLevels; level++) {
+            digits[level] = digitAt(key, level);
+            if (!testBit(nodes[level], digits[level])) {
+                break;
+            }
+            if (level == kNumLevels - 1) {
+                if (foundKey) {
+                    *foundKey = key;
+                }
+                return leafSlot(nodes[level], digits[level]);
+            }
+            nodes[level + 1] = childNode(nodes[level], digits[level]);
+        }
+
+        // Find the first present digit greater than the one we followed,
+        // backtracking towards the root when a level is exhausted
+        unsigned digit;
+        while ((digit = firstSetFrom(nodes[level], digits[level] + 1)) >= kFanout) {
+            if (level == 0) {
+                return nullptr;
+            }
+            level--;
+        }
+
+        // Descend along the smallest present children
+        for (;;) {
+            digits[level] = digit;
+            if (level == kNumLevels - 1) {
+                break;
+            }
+            nodes[level + 1] = childNode(nodes[level], digit);
+            level++;
+            digit = firstSetFrom(nodes[level], 0);
+        }
+
+        if (foundKey) {
+            uint64_t result = 0;
+            for (unsigned l = 0; l < kNumLevels; l++) {
+                result |= (uint64_t)digits[l] << levelShift(l);
+            }
+            *foundKey = result;
+        }
+        return leafSlot(nodes[kNumLevels - 1], digits[kNumLevels - 1]);
+    }
+
+    // Removes key and returns true if it was present; the removed value is
+    // copied to *value if given.
+    bool remove(uint64_t key, Value* value = nullptr) {
+        if (!keyInRange(key)) {
+            return false;
+        }
+
+        Node* nodes[kNumLevels];
+        unsigned digits[kNumLevels];
+
+        nodes[0] = &root;
+        for (unsigned level = 0; level < kNumLevels; level++) {
+            digits[level] = digitAt(key, level);
+            if (!testBit(nodes[level], digits[level])) {
+                return false;
+            }
+            if (level < kNumLevels - 1) {
+                nodes[level + 1] = childNode(nodes[level], digits[level]);
+            }
+        }
+
+        if (value) {
+            *value = *leafSlot(nodes[kNumLevels - 1], digits[kNumLevels - 1]);
+        }
+
+        // Clear presence bits bottom-up, releasing blocks whose word emptied
+        for (unsigned level = kNumLevels; level-- > 0;) {
+            Node* node = nodes[level];
+            unsigned word = digits[level] >> kChildBits;
+            node->bits[word] &= ~(1ULL << (digits[level] & (kBlockSize - 1)));
+            if (node->bits[word] == 0) {
+                objectPoolFree(level == kNumLevels - 1 ? &leafPool : &nonLeafPool, node->children[word]);
+                node->children[word] = nullptr;
+            }
+            if (!nodeEmpty(node)) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool empty() const {
+        return nodeEmpty(&root);
+    }
+
+    static constexpr unsigned levelShift(unsigned level) {
+        return (kNumLevels - level - 1) * StrideBits;
+    }
+
+private:
+    Node root;
+    ObjectPool nonLeafPool;
+    ObjectPool leafPool;
+
+    static constexpr bool keyInRange(uint64_t key) {
+        return KeyBits == 64 || (key >> (KeyBits % 64)) == 0;
+    }
+
+    static constexpr unsigned digitAt(uint64_t key, unsigned level) {
+        return (unsigned)(key >> levelShift(level)) & (kFanout - 1);
+    }
+
+    static bool testBit(const Node* node, unsigned digit) {
+        return (node->bits[digit >> kChildBits] >> (digit & (kBlockSize - 1))) & 1;
+    }
+
+    static Node* childNode(Node* node, unsigned digit) {
+        return &static_cast<Node*>(node->children[digit >> kChildBits])[digit & (kBlockSize - 1)];
+    }
+
+    static Value* leafSlot(Node* node, unsigned digit) {
+        return &static_cast<Value*>(node->children[digit >> kChildBits])[digit & (kBlockSize - 1)];
+    }
+
+    static bool nodeEmpty(const Node* node) {
+        uint64_t any = 0;
+        for (unsigned w = 0; w < kNumWords; w++) {
+            any |= node->bits[w];
+        }
+        return any == 0;
+    }
+
+    // Returns the first present digit >= from, or kFanout if there is none
+    static unsigned firstSetFrom(const Node* node, unsigned from) {
+        for (unsigned w = from >> kChildBits; w < kNumWords; w++) {
+            uint64_t word = node->bits[w];
+            if (w == (from >> kChildBits)) {
+                word &= ~0ULL << (from & (kBlockSize - 1));
+            }
+            if (word) {
+                return (w << kChildBits) | (unsigned)__builtin_ctzll(word);
+            }
+        }
+        return kFanout;
+    }
+
+    template <unsigned Level>
+    static Value* findAt(Node* node, uint64_t key) {
+        constexpr unsigned shift = levelShift(Level);
+        const unsigned digit = (unsigned)(key >> shift) & (kFanout - 1);
+        const unsigned word = digit >> kChildBits;
+        const unsigned child = digit & (kBlockSize - 1);
+
+        if (!(node->bits[word] & (1ULL << child))) {
+            return nullptr;
+        }
+        if constexpr (Level == kNumLevels - 1) {
+            return &static_cast<Value*>(node->children[word])[child];
+        } else {
+            return findAt<Level + 1>(&static_cast<Node*>(node->children[word])[child], key);
+        }
+    }
+
+    template <unsigned Level>
+    int insertAt(Node* node, uint64_t key, const Value& value, Value** existing) {
+        constexpr unsigned shift = levelShift(Level);
+        constexpr bool isLastLevel = (Level == kNumLevels - 1);
+        const unsigned digit = (unsigned)(key >> shift) & (kFanout - 1);
+        const unsigned word = digit >> kChildBits;
+        const unsigned child = digit & (kBlockSize - 1);
+
+        if (node->children[word] == nullptr) {
+            ObjectPool* pool = isLastLevel ? &leafPool : &nonLeafPool;
+            if (objectPoolAlloc(pool, &node->children[word]) == nullptr) {
+                return -1;
+            }
+            // Recycled blocks may hold stale data from a previous owner
+            memset(node->children[word], 0, pool->objectSize);
+        }
+
+        if constexpr (isLastLevel) {
+            Value* slot = &static_cast<Value*>(node->children[word])[child];
+            if (node->bits[word] & (1ULL << child)) {
+                *existing = slot;
+            } else {
+                node->bits[word] |= 1ULL << child;
+                *slot = value;
+            }
+            return 0;
+        } else {
+            int result = insertAt<Level + 1>(&static_cast<Node*>(node->children[word])[child], key, value, existing);
+            if (result == 0) {
+                node->bits[word] |= 1ULL << child;
+            }
+            return result;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,254 @@
+#include "radix_stride.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+static inline unsigned
+radixStrideDigit(NvU64 key, int shift)
+{
+    return (unsigned)(key >> shift) & (RADIX_STRIDE_FANOUT - 1);
+}
+
+static void
+radixStrideListInit(CUradixStrideNode *node)
+{
+    CU_ASSERT(node);
+
+    node->next = node;
+    node->prev = node;
+}
+
+static void
+radixStrideListInsert(CUradixStrideNode *node, CUradixStrideNode *head)
+{
+    CU_ASSERT(node);
+    CU_ASSERT(head);
+
+    CUradixStrideNode *prev = head->prev;
+    prev->next = node;
+    node->prev = prev;
+    head->prev = node;
+    node->next = head;
+}
+
+static void
+radixStrideListRemove(CUradixStrideNode *node)
+{
+    CU_ASSERT(node);
+
+    CUradixStrideNode *next = node->next;
+    CUradixStrideNode *prev = node->prev;
+
+    next->prev = prev;
+    prev->next = next;
+}
+
+static int
+radixStrideListEmpty(CUradixStrideNode *node)
+{
+    CU_ASSERT(node);
+    return node->next == node;
+}
+
+void
+radixStrideTreeInit(CUradixStrideTree *tree, NvU32 key_bits)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(key_bits > 0 && key_bits <= 64);
+
+    memset(tree, 0, sizeof(*tree));
+    tree->key_bits = key_bits;
+    // Round up to whole digits; the root's digit may be partly above key_bits
+    tree->top_shift = ((key_bits + RADIX_STRIDE_BITS - 1) / RADIX_STRIDE_BITS - 1) * RADIX_STRIDE_BITS;
+}
+
+NvBool
+radixStrideTreeEmpty(CUradixStrideTree *tree)
+{
+    CU_ASSERT(tree);
+    return (tree->root == NULL);
+}
+
+// Same contract as radixTreeReplaceNode: repl must be detached or a
+// non-primary node of the list.
+static void
+radixStrideTreeReplaceNode(CUradixStrideNode *orig, CUradixStrideNode *repl)
+{
+    unsigned i;
+    CU_ASSERT(repl->parent == NULL);
+    CU_ASSERT(repl->parent_to_self_ptr == NULL);
+
+    repl->parent_to_self_ptr = orig->parent_to_self_ptr;
+    repl->parent = orig->parent;
+
+    for (i = 0; i < RADIX_STRIDE_FANOUT; i++) {
+        CU_ASSERT(repl->child[i] == NULL);
+        repl->child[i] = orig->child[i];
+        if (repl->child[i]) {
+            repl->child[i]->parent_to_self_ptr = &repl->child[i];
+            repl->child[i]->parent = repl;
+        }
+    }
+
+    *(repl->parent_to_self_ptr) = repl;
+}
+
+// Same displacement scheme as radixTreeInsert: a smaller key takes over the
+// position it meets and the displaced node continues down.
+void
+radixStrideTreeInsert(CUradixStrideTree *tree, CUradixStrideNode *node, NvU64 key)
+{
+    CU_ASSERT(tree);
+    CU_ASSERT(tree->key_bits == 64 || ((~((1ULL << tree->key_bits) - 1)) & key) == 0);
+
+    CUradixStrideNode *parent = NULL;
+    CUradixStrideNode **parent_to_self_ptr = &tree->root;
+    int shift = (int)tree->top_shift + RADIX_STRIDE_BITS;
+
+    memset(node, 0, sizeof(*node));
+    node->key = key;
+    radixStrideListInit(node);
+
+    while (*parent_to_self_ptr && (*parent_to_self_ptr)->key != key) {
+        CUradixStrideNode *cur = *parent_to_self_ptr;
+
+        if (node->key < cur->key) {
+            CUradixStrideNode *swapNode;
+
+            radixStrideTreeReplaceNode(cur, node);
+
+            swapNode = cur;
+            cur = node;
+            node = swapNode;
+
+            memset(node->child, 0, sizeof(node->child));
+            node->parent = NULL;
+            node->parent_to_self_ptr = NULL;
+        }
+
+        parent = cur;
+        shift -= RADIX_STRIDE_BITS;
+        CU_ASSERT(shift >= 0);
+        parent_to_self_ptr = &cur->child[radixStrideDigit(node->key, shift)];
+    }
+
+    if (*parent_to_self_ptr) {
+        radixStrideListInsert(node, *parent_to_self_ptr);
+    }
+    else {
+        node->parent_to_self_ptr = parent_to_self_ptr;
+        *(node->parent_to_self_ptr) = node;
+        node->parent = parent;
+    }
+}
+
+// Deeper nodes on the key's path are larger, so the first one above the key
+// is the best on the path. Off the path, the best candidate is the root of
+// the lowest-digit subtree above the key's digit at the deepest level that
+// has one; anything on the path beats it.
+CUradixStrideNode *
+radixStrideTreeFindGEQ(CUradixStrideTree *tree, NvU64 key)
+{
+    CUradixStrideNode *node = tree->root;
+    CUradixStrideNode *found = NULL;
+    CUradixStrideNode *gt_tree = NULL;
+    int shift = (int)tree->top_shift + RADIX_STRIDE_BITS;
+
+    while (node) {
+        unsigned digit;
+        unsigned i;
+
+        if (node->key == key) {
+            return node;
+        }
+
+        if (node->key > key && found == NULL) {
+            found = node;
+        }
+
+        shift -= RADIX_STRIDE_BITS;
+        digit = radixStrideDigit(key, shift);
+
+        for (i = digit + 1; i < RADIX_STRIDE_FANOUT; i++) {
+            if (node->child[i]) {
+                gt_tree = node->child[i];
+                break;
+            }
+        }
+        node = node->child[digit];
+    }
+
+    if (!found) {
+        found = gt_tree;
+    }
+
+    return found;
+}
+
+// Single pass along the smaller-child chain, as in radixTreeRemove: each
+// chain node moves up into the vacated position and takes over that
+// position's other children.
+void
+radixStrideTreeRemove(CUradixStrideNode *node)
+{
+    CU_ASSERT(node);
+
+    if (radixStrideListEmpty(node)) {
+        CUradixStrideNode **slot = node->parent_to_self_ptr;
+        CUradixStrideNode *parent = node->parent;
+        CUradixStrideNode *children[RADIX_STRIDE_FANOUT];
+        unsigned i;
+
+        memcpy(children, node->child, sizeof(children));
+
+        for (;;) {
+            CUradixStrideNode *promoted = NULL;
+            unsigned childNumber = 0;
+
+            for (i = 0; i < RADIX_STRIDE_FANOUT; i++) {
+                if (children[i]) {
+                    promoted = children[i];
+                    childNumber = i;
+                    break;
+                }
+            }
+            if (promoted == NULL) {
+                *slot = NULL;
+                break;
+            }
+
+            *slot = promoted;
+            promoted->parent_to_self_ptr = slot;
+            promoted->parent = parent;
+
+            for (i = 0; i < RADIX_STRIDE_FANOUT; i++) {
+                CUradixStrideNode *promoted_child = promoted->child[i];
+                if (i != childNumber) {
+                    promoted->child[i] = children[i];
+                    if (children[i]) {
+                        children[i]->parent_to_self_ptr = &promoted->child[i];
+                        children[i]->parent = promoted;
+                    }
+                }
+                children[i] = promoted_child;
+            }
+
+            slot = &promoted->child[childNumber];
+            parent = promoted;
+        }
+    }
+    else {
+        // If this is the first element of the node (i.e., primary element),
+        // another element in the linked-list should step up and become
+        // primary.
+        if (node->parent_to_self_ptr) {
+            radixStrideTreeReplaceNode(node, node->next);
+            node->parent_to_self_ptr = NULL;
+        }
+        radixStrideListRemove(node);
+    }
+}
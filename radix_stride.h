@@ -0,0 +1,66 @@
+#ifndef __RADIX_STRIDE_H__
+#define __RADIX_STRIDE_H__
+
+#include "utils_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multi-bit stride variant of CUradixTree. Each level consumes
+// RADIX_STRIDE_BITS key bits and a node has 2^RADIX_STRIDE_BITS children,
+// indexed by that digit. The invariants are those of radix.c: a parent's key
+// is smaller than every key below it, and keys under a lower digit are
+// smaller than keys under a higher one, so FindGEQ is still a single descent
+// while the tree is about log2(fanout) times shallower.
+//
+// The default is a 4-way tree; build with -DRADIX_STRIDE_BITS=4 for 16-way
+// nodes at the cost of 96 more bytes per node.
+#ifndef RADIX_STRIDE_BITS
+#define RADIX_STRIDE_BITS 2
+#endif
+
+#define RADIX_STRIDE_FANOUT (1u << RADIX_STRIDE_BITS)
+
+typedef struct CUradixStrideNode_st CUradixStrideNode;
+typedef struct CUradixStrideTree_st CUradixStrideTree;
+
+struct CUradixStrideNode_st
+{
+    struct CUradixStrideNode_st *next;
+    struct CUradixStrideNode_st *prev;
+
+    struct CUradixStrideNode_st *child[RADIX_STRIDE_FANOUT];
+    struct CUradixStrideNode_st **parent_to_self_ptr;
+    struct CUradixStrideNode_st *parent;
+
+    NvU64 key; // Digits of this key will determine the location of a node
+};
+
+struct CUradixStrideTree_st
+{
+    struct CUradixStrideNode_st *root;
+    unsigned int key_bits;
+    unsigned int top_shift;  // Shift of the root's digit; key_bits rounded up to whole digits, minus one digit
+};
+
+CUDA_TEST_EXPORT void
+radixStrideTreeInit(CUradixStrideTree *tree, NvU32 key_bits);
+
+CUDA_TEST_EXPORT void
+radixStrideTreeInsert(CUradixStrideTree *tree, CUradixStrideNode *node, NvU64 key);
+
+CUDA_TEST_EXPORT void
+radixStrideTreeRemove(CUradixStrideNode *node);
+
+CUDA_TEST_EXPORT NvBool
+radixStrideTreeEmpty(CUradixStrideTree *tree);
+
+CUDA_TEST_EXPORT CUradixStrideNode *
+radixStrideTreeFindGEQ(CUradixStrideTree *tree, NvU64 key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,456 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avl.h"
+#include "test_common.h"
+
+#define NUM_KEYS 5000
+
+static CUavlTreeNode nodes[NUM_KEYS];
+static NvU64 keys[NUM_KEYS];
+static int present[NUM_KEYS];
+static NvU64 seed = 13;
+
+// Find, FindGEQ and FindLEQ against a scan of the present keys
+static int checkLookups(CUavlTree *tree, int num_queries)
+{
+    for (int q = 0; q < num_queries; q++) {
+        NvU64 query = testQuery(keys, NUM_KEYS, q, ~0ULL, &seed);
+        int geq = testBruteForceGEQ(keys, present, NUM_KEYS, query);
+        int leq = testBruteForceLEQ(keys, present, NUM_KEYS, query);
+        int exact = (geq >= 0 && keys[geq] == query) ? geq : -1;
+        CUavlTreeNode *found = cuAvlTreeNodeFindU64(tree, query);
+        CUavlTreeNode *found_geq = cuAvlTreeNodeFindGEQU64(tree, query);
+        CUavlTreeNode *found_leq = cuAvlTreeNodeFindLEQU64(tree, query);
+        if (found != (exact < 0 ? NULL : &nodes[exact]) ||
+            (geq < 0) != (found_geq == NULL) || (found_geq && cuAvlTreeNodeKeyU64(found_geq) != keys[geq]) ||
+            (leq < 0) != (found_leq == NULL) || (found_leq && cuAvlTreeNodeKeyU64(found_leq) != keys[leq])) {
+            printf("  Lookup of %lu returned the wrong node\n", query);
+            return -1;
+        }
+        // The generic entry points must agree on the same tree
+        if (cuAvlTreeNodeFindGEQ(tree, (CUavlTreeKey)(uintptr_t)query) != found_geq) {
+            printf("  Generic FindGEQ(%lu) disagrees with FindGEQU64\n", query);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// In-order walk visits exactly the present keys in increasing order
+static int checkOrder(CUavlTree *tree)
+{
+    int count = 0;
+    int expected = 0;
+    CUavlTreeNode *prev = NULL;
+
+    for (int i = 0; i < NUM_KEYS; i++) {
+        expected += present[i];
+    }
+    for (CUavlTreeNode *node = cuAvlTreeNodeFindGEQU64(tree, 0); node;
+         node = cuAvlTreeNodeInOrderSuccessor(tree, node)) {
+        if (prev && cuAvlTreeNodeKeyU64(prev) >= cuAvlTreeNodeKeyU64(node)) {
+            printf("  Keys %lu and %lu are out of order\n", cuAvlTreeNodeKeyU64(prev), cuAvlTreeNodeKeyU64(node));
+            return -1;
+        }
+        prev = node;
+        count++;
+    }
+    if (count != expected) {
+        printf("  In-order walk visited %d nodes, expected %d\n", count, expected);
+        return -1;
+    }
+    return 0;
+}
+
+// Rank, Select and CountRange against the present keys
+static int checkOrderStatistics(CUavlTree *tree, int num_queries)
+{
+    NvU64 count = 0;
+    for (int i = 0; i < NUM_KEYS; i++) {
+        count += present[i];
+    }
+    if (cuAvlTreeCount(tree) != count) {
+        printf("  Count is %lu, expected %lu\n", cuAvlTreeCount(tree), count);
+        return -1;
+    }
+    for (int q = 0; q < num_queries; q++) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 lo = (q & 1) ? (r >> 44) : keys[(r >> 32) % NUM_KEYS];
+        NvU64 hi = lo + ((q & 2) ? (testNextRandom(&seed) >> 20) : (testNextRandom(&seed) >> 46));
+        NvU64 rank = 0;
+        NvU64 in_range = 0;
+        for (int i = 0; i < NUM_KEYS; i++) {
+            if (present[i]) {
+                rank += (keys[i] < lo);
+                in_range += (keys[i] >= lo && keys[i] < hi);
+            }
+        }
+        CUavlTreeNode *selected = cuAvlTreeSelect(tree, rank);
+        if (cuAvlTreeRank(tree, (CUavlTreeKey)(uintptr_t)lo) != rank ||
+            cuAvlTreeCountRange(tree, (CUavlTreeKey)(uintptr_t)lo, (CUavlTreeKey)(uintptr_t)hi) != in_range ||
+            selected != cuAvlTreeNodeFindGEQU64(tree, lo)) {
+            printf("  Rank, Select or CountRange wrong around %lu\n", lo);
+            return -1;
+        }
+    }
+    if (cuAvlTreeSelect(tree, count) != NULL) {
+        printf("  Select past the end returned a node\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main() {
+    printf("Testing NvU64-Keyed AVL Tree\n");
+    printf("============================\n");
+
+    CUavlTree tree;
+    cuAvlTreeInitializeU64(&tree, NULL);
+    if (cuAvlTreeNodeFindGEQU64(&tree, 0) != NULL || cuAvlTreeNodeFindLEQU64(&tree, ~0ULL) != NULL) {
+        printf("New tree is not empty\n");
+        return -1;
+    }
+
+    // Duplicates must be refused and leave the existing node in place
+    int duplicates = 0;
+    testFillKeys(keys, NUM_KEYS, ~0ULL, &seed);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        CUavlTreeNode *existing = cuAvlTreeNodeInsertOrReturnExistingU64(&tree, &nodes[i], keys[i], &keys[i]);
+        if (existing) {
+            if (cuAvlTreeNodeKeyU64(existing) != keys[i] ||
+                cuAvlTreeNodeInsertU64(&tree, &nodes[i], keys[i], &keys[i]) != CU_AVL_TREE_STATUS_KEY_EXISTS) {
+                printf("  Duplicate insert of %lu not refused\n", keys[i]);
+                return -1;
+            }
+            duplicates++;
+            continue;
+        }
+        present[i] = 1;
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkLookups(&tree, 5000) != 0 || checkOrder(&tree) != 0) {
+        return -1;
+    }
+    printf("Inserted %d keys (%d duplicates refused), lookups verified\n", NUM_KEYS - duplicates, duplicates);
+
+    // Remove half in scattered order
+    for (int i = 0; i < NUM_KEYS; i++) {
+        int index = testScatteredIndex(i, NUM_KEYS);
+        if (index % 2 == 0 && present[index]) {
+            cuAvlTreeNodeRemove(&tree, &nodes[index]);
+            present[index] = 0;
+        }
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkLookups(&tree, 5000) != 0 || checkOrder(&tree) != 0) {
+        return -1;
+    }
+    printf("Removed half of the keys, lookups verified\n");
+
+    // Remove everything else
+    for (int i = NUM_KEYS - 1; i >= 0; i--) {
+        if (present[i]) {
+            cuAvlTreeNodeRemove(&tree, &nodes[i]);
+            present[i] = 0;
+        }
+    }
+    if (tree.root != NULL) {
+        printf("Tree not empty after removing every key\n");
+        return -1;
+    }
+    printf("Full removal verified\n");
+
+    cuAvlTreeDeinitialize(&tree);
+
+    // Keys at both ends of the range and around the sign bit, where a
+    // subtracting comparison would overflow
+    NvU64 edge_keys[] = { 0, 1, 2, 1ULL << 62, (1ULL << 63) - 1, 1ULL << 63, (1ULL << 63) + 1,
+                          ~0ULL - 2, ~0ULL - 1, ~0ULL };
+    int num_edge = (int)(sizeof(edge_keys) / sizeof(edge_keys[0]));
+    cuAvlTreeInitializeU64(&tree, NULL);
+    for (int i = 0; i < num_edge; i++) {
+        // Descending order, so the high keys go in first
+        int index = num_edge - 1 - i;
+        keys[index] = edge_keys[index];
+        if (cuAvlTreeNodeInsertU64(&tree, &nodes[index], keys[index], NULL) != CU_AVL_TREE_STATUS_SUCCESS) {
+            printf("  Insert of edge key %lx failed\n", keys[index]);
+            return -1;
+        }
+        present[index] = 1;
+    }
+    for (int removed = 0; removed <= num_edge; removed++) {
+        cuAvlTreeAssertValid(&tree);
+        for (int i = 0; i < num_edge; i++) {
+            NvU64 queries[3] = { edge_keys[i], edge_keys[i] - 1, edge_keys[i] + 1 };
+            for (int q = 0; q < 3; q++) {
+                int geq = testBruteForceGEQ(keys, present, num_edge, queries[q]);
+                int leq = testBruteForceLEQ(keys, present, num_edge, queries[q]);
+                if (cuAvlTreeNodeFindGEQU64(&tree, queries[q]) != (geq < 0 ? NULL : &nodes[geq]) ||
+                    cuAvlTreeNodeFindLEQU64(&tree, queries[q]) != (leq < 0 ? NULL : &nodes[leq]) ||
+                    cuAvlTreeNodeFindU64(&tree, queries[q]) !=
+                        ((geq >= 0 && keys[geq] == queries[q]) ? &nodes[geq] : NULL)) {
+                    printf("  Lookup of edge key %lx returned the wrong node\n", queries[q]);
+                    return -1;
+                }
+            }
+        }
+        // Remove from both ends inwards
+        if (removed < num_edge) {
+            int index = (removed & 1) ? num_edge - 1 - removed / 2 : removed / 2;
+            cuAvlTreeNodeRemove(&tree, &nodes[index]);
+            present[index] = 0;
+        }
+    }
+    if (tree.root != NULL) {
+        printf("  Tree not empty after removing the edge keys\n");
+        return -1;
+    }
+    cuAvlTreeDeinitialize(&tree);
+    printf("Keys near 0 and ~0ULL verified\n");
+
+    // Generic inserts with keys passed as (CUavlTreeKey)(uintptr_t)key and
+    // U64 inserts on one tree: the two must see each other's keys
+    cuAvlTreeInitializeU64(&tree, NULL);
+    testFillKeys(keys, NUM_KEYS, ~0ULL, &seed);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        CUavlTreeStatus status = (i & 1)
+            ? cuAvlTreeNodeInsert(&tree, &nodes[i], (CUavlTreeKey)(uintptr_t)keys[i], &keys[i])
+            : cuAvlTreeNodeInsertU64(&tree, &nodes[i], keys[i], &keys[i]);
+        present[i] = (status == CU_AVL_TREE_STATUS_SUCCESS);
+        if (!present[i] && cuAvlTreeNodeFindU64(&tree, keys[i]) == NULL) {
+            printf("  Insert of %lu refused without an existing key\n", keys[i]);
+            return -1;
+        }
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkLookups(&tree, 5000) != 0 || checkOrder(&tree) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < NUM_KEYS; i++) {
+        CUavlTreeNode *found = cuAvlTreeNodeFind(&tree, (CUavlTreeKey)(uintptr_t)keys[i]);
+        if (found != cuAvlTreeNodeFindU64(&tree, keys[i]) || cuAvlTreeNodeKeyU64(found) != keys[i] ||
+            (present[i] && found != &nodes[i])) {
+            printf("  Generic and U64 Find disagree on %lu\n", keys[i]);
+            return -1;
+        }
+    }
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (present[i]) {
+            cuAvlTreeNodeRemove(&tree, &nodes[i]);
+            present[i] = 0;
+        }
+    }
+    cuAvlTreeDeinitialize(&tree);
+    printf("Generic and U64 entry points mixed on one tree verified\n");
+
+    // Bulk build from pooled nodes at sizes around powers of two; the result
+    // must be a valid AVL tree of minimal height holding every key in order
+    CUavlTreeNodePool pool;
+    static CUavlTreeNode *sorted[NUM_KEYS];
+    cuAvlTreeNodePoolInitialize(&pool, 64);
+    for (int count = 0; count <= NUM_KEYS; count = (count < 70) ? count + 1 : count * 2 - 1) {
+        int min_height = 0;
+        while ((1 << min_height) - 1 < count) {
+            min_height++;
+        }
+        cuAvlTreeInitializeU64(&tree, NULL);
+        for (int i = 0; i < count; i++) {
+            sorted[i] = cuAvlTreeNodePoolAlloc(&pool);
+            sorted[i]->key = (CUavlTreeKey)(uintptr_t)((NvU64)i * 3 + 1);
+            sorted[i]->value = NULL;
+        }
+        cuAvlTreeBuildFromSorted(&tree, sorted, count);
+        cuAvlTreeAssertValid(&tree);
+        if ((tree.root ? tree.root->height : 0) != min_height) {
+            printf("  Built tree of %d nodes has height %d, expected %d\n", count, tree.root->height, min_height);
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            CUavlTreeNode *next = cuAvlTreeNodeInOrderSuccessor(&tree, sorted[i]);
+            if (cuAvlTreeNodeFindU64(&tree, (NvU64)i * 3 + 1) != sorted[i] ||
+                cuAvlTreeNodeFindGEQU64(&tree, (NvU64)i * 3) != sorted[i] ||
+                next != (i + 1 < count ? sorted[i + 1] : NULL)) {
+                printf("  Built tree of %d nodes has node %d out of place\n", count, i);
+                return -1;
+            }
+        }
+
+        // The built tree must keep working as an ordinary AVL tree
+        for (int i = 0; i < count; i += 2) {
+            cuAvlTreeNodeRemove(&tree, sorted[i]);
+            cuAvlTreeNodePoolFree(&pool, sorted[i]);
+        }
+        for (int i = 0; i < count; i += 2) {
+            cuAvlTreeNodeInsertU64(&tree, cuAvlTreeNodePoolAlloc(&pool), (NvU64)i * 3 + 2, NULL);
+        }
+        cuAvlTreeAssertValid(&tree);
+        for (int i = 1; i < count; i += 2) {
+            cuAvlTreeNodeRemove(&tree, sorted[i]);
+            cuAvlTreeNodePoolFree(&pool, sorted[i]);
+        }
+        if (count > 0 && cuAvlTreeNodeKeyU64(cuAvlTreeNodeFindGEQU64(&tree, 0)) != 2) {
+            printf("  Built tree of %d nodes lost keys after updates\n", count);
+            return -1;
+        }
+        // Leftover nodes are dropped with the tree and reclaimed with the pool
+        cuAvlTreeDeinitialize(&tree);
+    }
+    cuAvlTreeNodePoolDeinitialize(&pool);
+    printf("BuildFromSorted and node pool verified\n");
+
+    // Split at assorted keys: both halves valid and holding exactly the keys
+    // on their side; joining them back must restore the full tree
+    cuAvlTreeInitializeU64(&tree, NULL);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        present[i] = (cuAvlTreeNodeInsertU64(&tree, &nodes[i], keys[i], &keys[i]) == CU_AVL_TREE_STATUS_SUCCESS);
+    }
+    for (int s = 0; s < 200; s++) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 split_key = (s % 4 == 0) ? r : (s % 4 == 1) ? (r >> 44) : (s % 4 == 2) ? keys[(r >> 32) % NUM_KEYS] : (NvU64)s - 3;
+        CUavlTree upper;
+        int expected_left = 0;
+        int expected_right = 0;
+        cuAvlTreeSplit(&tree, (CUavlTreeKey)(uintptr_t)split_key, &tree, &upper);
+        cuAvlTreeAssertValid(&tree);
+        cuAvlTreeAssertValid(&upper);
+        for (int i = 0; i < NUM_KEYS; i++) {
+            if (!present[i]) {
+                continue;
+            }
+            CUavlTree *side = (keys[i] < split_key) ? &tree : &upper;
+            if (cuAvlTreeNodeFindU64(side, keys[i]) != &nodes[i]) {
+                printf("  Split at %lu put key %lu on the wrong side\n", split_key, keys[i]);
+                return -1;
+            }
+            expected_left += (keys[i] < split_key);
+            expected_right += (keys[i] >= split_key);
+        }
+        int left_count = 0;
+        int right_count = 0;
+        for (CUavlTreeNode *node = cuAvlTreeNodeFindGEQU64(&tree, 0); node; node = cuAvlTreeNodeInOrderSuccessor(&tree, node)) {
+            left_count++;
+        }
+        for (CUavlTreeNode *node = cuAvlTreeNodeFindGEQU64(&upper, 0); node; node = cuAvlTreeNodeInOrderSuccessor(&upper, node)) {
+            right_count++;
+        }
+        if (left_count != expected_left || right_count != expected_right) {
+            printf("  Split at %lu gave %d + %d keys, expected %d + %d\n",
+                   split_key, left_count, right_count, expected_left, expected_right);
+            return -1;
+        }
+
+        cuAvlTreeJoin(&tree, &upper);
+        cuAvlTreeAssertValid(&tree);
+        if (upper.root != NULL || checkLookups(&tree, 20) != 0 || checkOrder(&tree) != 0) {
+            printf("  Join after split at %lu lost keys\n", split_key);
+            return -1;
+        }
+    }
+
+    // Extract a middle range and join trees of very different heights
+    NvU64 first = keys[1] / 4;
+    NvU64 last = first * 3;
+    CUavlTree range;
+    CUavlTree upper;
+    cuAvlTreeSplit(&tree, (CUavlTreeKey)(uintptr_t)first, &tree, &upper);
+    cuAvlTreeSplit(&upper, (CUavlTreeKey)(uintptr_t)last, &range, &upper);
+    cuAvlTreeAssertValid(&range);
+    for (CUavlTreeNode *node = cuAvlTreeNodeFindGEQU64(&range, 0); node; node = cuAvlTreeNodeInOrderSuccessor(&range, node)) {
+        if (cuAvlTreeNodeKeyU64(node) < first || cuAvlTreeNodeKeyU64(node) >= last) {
+            printf("  Extracted range holds key %lu outside [%lu, %lu)\n", cuAvlTreeNodeKeyU64(node), first, last);
+            return -1;
+        }
+    }
+    cuAvlTreeJoin(&tree, &range);
+    cuAvlTreeJoin(&tree, &upper);
+    cuAvlTreeAssertValid(&tree);
+    if (checkLookups(&tree, 1000) != 0 || checkOrder(&tree) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < NUM_KEYS; i++) {
+        CUavlTree single;
+        if (!present[i] || i % 7 != 0) {
+            continue;
+        }
+        // Split off one key and join it back from either side
+        cuAvlTreeSplit(&tree, (CUavlTreeKey)(uintptr_t)keys[i], &tree, &upper);
+        cuAvlTreeSplit(&upper, (CUavlTreeKey)(uintptr_t)(keys[i] + 1), &single, &upper);
+        if (single.root != &nodes[i] || single.root->left || single.root->right) {
+            printf("  Splitting out key %lu did not leave it alone\n", keys[i]);
+            return -1;
+        }
+        cuAvlTreeJoin(&single, &upper);
+        cuAvlTreeJoin(&tree, &single);
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkLookups(&tree, 1000) != 0 || checkOrder(&tree) != 0) {
+        return -1;
+    }
+    cuAvlTreeDeinitialize(&tree);
+    printf("Split and join verified\n");
+
+    // Subtree counts through inserts, removes, split/join and bulk build;
+    // cuAvlTreeAssertValid also checks every count
+    cuAvlTreeInitializeU64WithFlags(&tree, NULL, CU_AVL_TREE_FLAG_COUNTS);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        present[i] = (cuAvlTreeNodeInsertU64(&tree, &nodes[i], keys[i], &keys[i]) == CU_AVL_TREE_STATUS_SUCCESS);
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkOrderStatistics(&tree, 1000) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < NUM_KEYS; i += 3) {
+        if (present[i]) {
+            cuAvlTreeNodeRemove(&tree, &nodes[i]);
+            present[i] = 0;
+        }
+    }
+    cuAvlTreeAssertValid(&tree);
+    if (checkOrderStatistics(&tree, 1000) != 0) {
+        return -1;
+    }
+    CUavlTree counted_upper;
+    NvU64 below = 0;
+    NvU64 above = 0;
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (present[i]) {
+            below += (keys[i] < keys[7]);
+            above += (keys[i] >= keys[7]);
+        }
+    }
+    cuAvlTreeSplit(&tree, (CUavlTreeKey)(uintptr_t)keys[7], &tree, &counted_upper);
+    cuAvlTreeAssertValid(&tree);
+    cuAvlTreeAssertValid(&counted_upper);
+    if (cuAvlTreeCount(&tree) != below || cuAvlTreeCount(&counted_upper) != above) {
+        printf("  Split counts %lu + %lu, expected %lu + %lu\n",
+               cuAvlTreeCount(&tree), cuAvlTreeCount(&counted_upper), below, above);
+        return -1;
+    }
+    cuAvlTreeJoin(&tree, &counted_upper);
+    cuAvlTreeAssertValid(&tree);
+    if (checkOrderStatistics(&tree, 1000) != 0) {
+        return -1;
+    }
+    cuAvlTreeDeinitialize(&tree);
+
+    cuAvlTreeInitializeU64WithFlags(&tree, NULL, CU_AVL_TREE_FLAG_COUNTS);
+    for (int i = 0; i < 1000; i++) {
+        nodes[i].key = (CUavlTreeKey)(uintptr_t)((NvU64)i * 10);
+        sorted[i] = &nodes[i];
+    }
+    cuAvlTreeBuildFromSorted(&tree, sorted, 1000);
+    cuAvlTreeAssertValid(&tree);
+    for (int i = 0; i < 1000; i++) {
+        if (cuAvlTreeSelect(&tree, i) != &nodes[i] ||
+            cuAvlTreeRank(&tree, (CUavlTreeKey)(uintptr_t)((NvU64)i * 10 + 1)) != (NvU64)i + 1) {
+            printf("  Built tree has wrong order statistics at %d\n", i);
+            return -1;
+        }
+    }
+    cuAvlTreeDeinitialize(&tree);
+    printf("Rank, Select and CountRange verified\n");
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
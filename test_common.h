@@ -0,0 +1,74 @@
+#ifndef __TEST_COMMON_H__
+#define __TEST_COMMON_H__
+
+#include "utils_types.h"
+
+// Helpers shared by the tree and allocator tests: the random source and the
+// brute-force scans of a keys[]/present[] table that structures are
+// cross-checked against. Tests use these rather than local copies.
+
+// 64-bit LCG; each test keeps its own seed so runs are reproducible
+static inline NvU64
+testNextRandom(NvU64 *seed)
+{
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *seed;
+}
+
+// Key mix: full-width random keys, small clustered keys (the top 20 bits of
+// a random value) and, every fifth key, a duplicate of an earlier one. Keys
+// are masked to the tree's key width.
+static inline void
+testFillKeys(NvU64 *keys, int num_keys, NvU64 key_mask, NvU64 *seed)
+{
+    for (int i = 0; i < num_keys; i++) {
+        NvU64 r = testNextRandom(seed);
+        keys[i] = ((i % 5 == 4) ? keys[i / 3] : (i & 1) ? r : (r >> 44)) & key_mask;
+    }
+}
+
+// Query mix for the q-th query: a random key, a small clustered key, or a
+// present-or-not key equal to or just above one in keys[]
+static inline NvU64
+testQuery(const NvU64 *keys, int num_keys, int q, NvU64 key_mask, NvU64 *seed)
+{
+    NvU64 r = testNextRandom(seed);
+    NvU64 query = (q % 3 == 0) ? r : (q % 3 == 1) ? (r >> 44) : keys[(r >> 32) % num_keys] + (q & 1);
+    return query & key_mask;
+}
+
+// Index of the smallest present key >= query, -1 if none
+static inline int
+testBruteForceGEQ(const NvU64 *keys, const int *present, int num_keys, NvU64 query)
+{
+    int best = -1;
+    for (int i = 0; i < num_keys; i++) {
+        if (present[i] && keys[i] >= query && (best < 0 || keys[i] < keys[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Index of the largest present key <= query, -1 if none
+static inline int
+testBruteForceLEQ(const NvU64 *keys, const int *present, int num_keys, NvU64 query)
+{
+    int best = -1;
+    for (int i = 0; i < num_keys; i++) {
+        if (present[i] && keys[i] <= query && (best < 0 || keys[i] > keys[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// The i-th index of a fixed scattered permutation of [0, num_keys), for
+// removing keys in an order unrelated to insertion
+static inline int
+testScatteredIndex(int i, int num_keys)
+{
+    return (int)(((NvU64)i * 7919) % (NvU64)num_keys);
+}
+
+#endif
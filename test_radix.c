@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "radix.h"
+#include "test_common.h"
 
 int main() {
     CUradixTree tree;
@@ -44,6 +45,216 @@ int main() {
         }
     }
     
+    printf("\nTesting radixTreeFindLEQ:\n");
+    for (int i = 0; i < num_search; i++) {
+        CUradixNode *found = radixTreeFindLEQ(&tree, search_keys[i]);
+        if (found) {
+            printf("  Search for %lu: Found node with key %lu\n", search_keys[i], found->key);
+        } else {
+            printf("  Search for %lu: No node found\n", search_keys[i]);
+        }
+    }
+
+    printf("\nIterating in order:");
+    for (CUradixNode *node = radixTreeFindGEQ(&tree, 0); node; node = radixTreeNext(node)) {
+        printf(" %lu", node->key);
+    }
+    printf("\n");
+
+    // Cross-check against a brute-force scan on a larger tree with
+    // duplicates, clustered keys and keys spread over the whole range
+    printf("\nChecking FindLEQ/Next/Prev against brute force...\n");
+    enum { NUM_RANDOM = 2000 };
+    static CUradixNode random_nodes[NUM_RANDOM];
+    static NvU64 random_keys[NUM_RANDOM];
+    static int present[NUM_RANDOM];
+    CUradixTree random_tree;
+    NvU64 seed = 12345;
+    radixTreeInit(&random_tree, 64);
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        NvU64 r = testNextRandom(&seed);
+        if (i % 4 == 0) {
+            random_keys[i] = r;
+        } else if (i % 4 == 1 && i > 1) {
+            random_keys[i] = random_keys[i / 2];  // duplicate
+        } else {
+            random_keys[i] = (r >> 40) & 0xFFF;
+        }
+        radixTreeInsert(&random_tree, &random_nodes[i], random_keys[i]);
+        present[i] = 1;
+    }
+    for (int q = 0; q < 4000; q++) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 query = (q % 3 == 0) ? r : (q % 3 == 1) ? (r >> 40) & 0xFFF : random_keys[q % NUM_RANDOM] - 1;
+        int best = testBruteForceLEQ(random_keys, present, NUM_RANDOM, query);
+        CUradixNode *found = radixTreeFindLEQ(&random_tree, query);
+        if ((best < 0) != (found == NULL) || (found && found->key != random_keys[best])) {
+            printf("  FindLEQ(%lu) returned the wrong node\n", query);
+            return 1;
+        }
+    }
+
+    int visited = 0;
+    NvU64 last_key = 0;
+    CUradixNode *last = NULL;
+    for (CUradixNode *node = radixTreeFindGEQ(&random_tree, 0); node; node = radixTreeNext(node)) {
+        if ((visited > 0 && node->key < last_key) || radixTreePrev(node) != last) {
+            printf("  Iteration out of order at key %lu\n", node->key);
+            return 1;
+        }
+        last_key = node->key;
+        last = node;
+        visited++;
+    }
+    if (visited != NUM_RANDOM || last != radixTreeFindLEQ(&random_tree, ~0ULL)->prev) {
+        printf("  Iteration visited %d of %d nodes\n", visited, NUM_RANDOM);
+        return 1;
+    }
+    printf("  %d nodes visited in order, %d LEQ queries matched\n", visited, 4000);
+
+    // Extract best fits until the tree is empty, checking each against the
+    // smallest remaining key >= the request
+    printf("\nChecking ExtractGEQ against brute force...\n");
+    int num_extracted = 0;
+    while (num_extracted < NUM_RANDOM) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 request = (r & 1) ? (r >> 40) & 0xFFF : r >> 1;
+        int best = testBruteForceGEQ(random_keys, present, NUM_RANDOM, request);
+        CUradixNode *node = radixTreeExtractGEQ(&random_tree, request);
+        if ((best < 0) != (node == NULL) || (node && node->key != random_keys[best])) {
+            printf("  ExtractGEQ(%lu) returned the wrong node\n", request);
+            return 1;
+        }
+        if (node) {
+            int index = (int)(node - random_nodes);
+            if (!present[index]) {
+                printf("  ExtractGEQ(%lu) returned a node twice\n", request);
+                return 1;
+            }
+            present[index] = 0;
+            num_extracted++;
+        } else {
+            // Nothing fits; take the smallest node to keep the tree shrinking
+            node = radixTreeExtractGEQ(&random_tree, 0);
+            present[node - random_nodes] = 0;
+            num_extracted++;
+        }
+    }
+    if (!radixTreeEmpty(&random_tree)) {
+        printf("  Tree not empty after extracting every node\n");
+        return 1;
+    }
+    printf("  %d nodes extracted in best-fit order\n", num_extracted);
+
+    // Remove half of the nodes in scattered order (primaries with and
+    // without duplicates, and list nodes), then check that GEQ/LEQ and
+    // iteration still agree with a brute-force scan of the survivors
+    printf("\nChecking Remove against brute force...\n");
+    radixTreeInit(&random_tree, 64);
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        radixTreeInsert(&random_tree, &random_nodes[i], random_keys[i]);
+        present[i] = 1;
+    }
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        int index = testScatteredIndex(i, NUM_RANDOM);
+        if (index % 2 == 0) {
+            radixTreeRemove(&random_nodes[index]);
+            present[index] = 0;
+        }
+    }
+    for (int q = 0; q < 4000; q++) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 query = (q & 1) ? r : (r >> 40) & 0xFFF;
+        int geq = testBruteForceGEQ(random_keys, present, NUM_RANDOM, query);
+        int leq = testBruteForceLEQ(random_keys, present, NUM_RANDOM, query);
+        CUradixNode *found_geq = radixTreeFindGEQ(&random_tree, query);
+        CUradixNode *found_leq = radixTreeFindLEQ(&random_tree, query);
+        if (radixTreeFindGEQBranchless(&random_tree, query) != found_geq) {
+            printf("  FindGEQBranchless(%lu) differs from FindGEQ\n", query);
+            return 1;
+        }
+        if ((geq < 0) != (found_geq == NULL) || (found_geq && found_geq->key != random_keys[geq]) ||
+            (leq < 0) != (found_leq == NULL) || (found_leq && found_leq->key != random_keys[leq])) {
+            printf("  Search for %lu disagrees after removal\n", query);
+            return 1;
+        }
+    }
+    visited = 0;
+    for (CUradixNode *node = radixTreeFindGEQ(&random_tree, 0); node; node = radixTreeNext(node)) {
+        if (!present[node - random_nodes]) {
+            printf("  Removed node with key %lu still in the tree\n", node->key);
+            return 1;
+        }
+        visited++;
+    }
+    if (visited != NUM_RANDOM / 2) {
+        printf("  Iteration visited %d of %d nodes after removal\n", visited, NUM_RANDOM / 2);
+        return 1;
+    }
+    printf("  %d nodes left after removal\n", visited);
+
+    // Hinted operations: every surviving node's level must match its depth,
+    // FindGEQFrom must agree with FindGEQ from any hint, and searches must
+    // stay exact after reinserting with InsertNear
+    printf("\nChecking InsertNear/FindGEQFrom against brute force...\n");
+    static CUradixNode *survivors[NUM_RANDOM];
+    int num_survivors = 0;
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        if (present[i]) {
+            survivors[num_survivors++] = &random_nodes[i];
+        }
+    }
+    for (int q = 0; q < 4000; q++) {
+        NvU64 r = testNextRandom(&seed);
+        CUradixNode *hint = survivors[(r >> 20) % num_survivors];
+        NvU64 query = (q % 3 == 0) ? r : (q % 3 == 1) ? (r >> 40) & 0xFFF : hint->key + (r & 0xF) - 8;
+        if (radixTreeFindGEQFrom(hint, query) != radixTreeFindGEQ(&random_tree, query)) {
+            printf("  FindGEQFrom(hint %lu, %lu) differs from FindGEQ\n", hint->key, query);
+            return 1;
+        }
+    }
+    CUradixNode *hint = survivors[0];
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        if (!present[i]) {
+            // Alternate between the previous insert and a random survivor
+            NvU64 r = testNextRandom(&seed);
+            if (r & 1) {
+                hint = survivors[(r >> 20) % num_survivors];
+            }
+            radixTreeInsertNear(&random_tree, hint, &random_nodes[i], random_keys[i]);
+            present[i] = 1;
+            hint = &random_nodes[i];
+        }
+    }
+    for (int i = 0; i < NUM_RANDOM; i++) {
+        CUradixNode *node = &random_nodes[i];
+        if (node->parent_to_self_ptr &&
+            node->cur_key_bit != (node->parent ? node->parent->cur_key_bit - 1 : 64)) {
+            printf("  Node %lu has level %u, parent level %u\n", node->key, node->cur_key_bit,
+                   node->parent ? node->parent->cur_key_bit : 0);
+            return 1;
+        }
+    }
+    for (int q = 0; q < 4000; q++) {
+        NvU64 r = testNextRandom(&seed);
+        NvU64 query = (q & 1) ? r : (r >> 40) & 0xFFF;
+        int geq = testBruteForceGEQ(random_keys, present, NUM_RANDOM, query);
+        CUradixNode *found = radixTreeFindGEQFrom(&random_nodes[q % NUM_RANDOM], query);
+        if ((geq < 0) != (found == NULL) || (found && found->key != random_keys[geq])) {
+            printf("  Search for %lu disagrees after InsertNear\n", query);
+            return 1;
+        }
+    }
+    visited = 0;
+    for (CUradixNode *node = radixTreeFindGEQ(&random_tree, 0); node; node = radixTreeNext(node)) {
+        visited++;
+    }
+    if (visited != NUM_RANDOM) {
+        printf("  Iteration visited %d of %d nodes after InsertNear\n", visited, NUM_RANDOM);
+        return 1;
+    }
+    printf("  %d nodes reinserted near a hint, levels and searches consistent\n", NUM_RANDOM / 2);
+
     printf("\nTest completed successfully!\n");
     return 0;
 } 
\ No newline at end of file
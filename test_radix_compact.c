@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_compact.h"
+#include "test_common.h"
+
+#define NUM_KEYS 5000
+
+static CUradixCompactHandle handles[NUM_KEYS];
+static NvU64 keys[NUM_KEYS];
+static int present[NUM_KEYS];
+static NvU64 seed = 7;
+
+static int checkFindGEQ(CUradixCompactTree *tree, int num_queries)
+{
+    for (int q = 0; q < num_queries; q++) {
+        NvU64 query = testQuery(keys, NUM_KEYS, q, ~0ULL, &seed);
+        int best = testBruteForceGEQ(keys, present, NUM_KEYS, query);
+        CUradixCompactHandle found = radixCompactTreeFindGEQ(tree, query);
+        if ((best < 0) != (found == RADIX_COMPACT_NULL) ||
+            (found != RADIX_COMPACT_NULL && radixCompactTreeKey(tree, found) != keys[best])) {
+            printf("  FindGEQ(%lu) returned the wrong node\n", query);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    printf("Testing Compact Radix Tree Implementation\n");
+    printf("=========================================\n");
+
+    CUradixCompactTree tree;
+    // Start small so that the arrays grow several times
+    if (radixCompactTreeInit(&tree, 64, 16) != 0) {
+        printf("Failed to initialize tree\n");
+        return -1;
+    }
+    printf("Node layout: %zu hot + %zu cold bytes\n", sizeof(CUradixCompactHot), sizeof(CUradixCompactCold));
+
+    testFillKeys(keys, NUM_KEYS, ~0ULL, &seed);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        handles[i] = radixCompactTreeInsert(&tree, keys[i]);
+        if (handles[i] == RADIX_COMPACT_NULL || radixCompactTreeKey(&tree, handles[i]) != keys[i]) {
+            printf("Failed to insert key %lu\n", keys[i]);
+            return -1;
+        }
+        present[i] = 1;
+    }
+    if (checkFindGEQ(&tree, 5000) != 0) {
+        return -1;
+    }
+    printf("Inserted %d keys, FindGEQ matches brute force\n", NUM_KEYS);
+
+    // Remove half in scattered order; handles of the rest must stay valid
+    for (int i = 0; i < NUM_KEYS; i++) {
+        int index = testScatteredIndex(i, NUM_KEYS);
+        if (index % 2 == 0) {
+            radixCompactTreeRemove(&tree, handles[index]);
+            present[index] = 0;
+        }
+    }
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (present[i] && radixCompactTreeKey(&tree, handles[i]) != keys[i]) {
+            printf("Handle of key %lu changed after removals\n", keys[i]);
+            return -1;
+        }
+    }
+    if (checkFindGEQ(&tree, 5000) != 0) {
+        return -1;
+    }
+    printf("Removed half of the keys, FindGEQ matches brute force\n");
+
+    // Reinsert into recycled slots, then remove everything
+    NvU32 used = tree.used;
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (!present[i]) {
+            handles[i] = radixCompactTreeInsert(&tree, keys[i]);
+            present[i] = 1;
+        }
+    }
+    if (tree.used != used) {
+        printf("Reinsertion did not reuse freed slots\n");
+        return -1;
+    }
+    if (checkFindGEQ(&tree, 2000) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < NUM_KEYS; i++) {
+        radixCompactTreeRemove(&tree, handles[i]);
+        present[i] = 0;
+    }
+    if (!radixCompactTreeEmpty(&tree) || radixCompactTreeFindGEQ(&tree, 0) != RADIX_COMPACT_NULL) {
+        printf("Tree not empty after removing every key\n");
+        return -1;
+    }
+    printf("Reinsertion and full removal verified\n");
+
+    radixCompactTreeDestroy(&tree);
+    printf("\nAll tests completed!\n");
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "radix_concurrent.h"
+#include "test_common.h"
+
+#define NUM_READERS 3
+#define NUM_WRITES 50000
+#define NUM_CHURN 512
+#define STABLE_STRIDE 1024ULL
+#define NUM_STABLE 1024ULL
+
+// Keys that are multiples of STABLE_STRIDE are inserted up front and never
+// removed, so whatever the writer is doing, FindGEQ(q) must return a key in
+// [q, q rounded up to the stride] for every q below the last stable key.
+static CUradixConcurrentTree tree;
+static CUradixNode stable_nodes[NUM_STABLE];
+static volatile int writer_done;
+static NvU64 reader_queries[NUM_READERS];
+static int reader_failed;
+
+static void *readerThread(void *arg)
+{
+    int id = (int)(size_t)arg;
+    NvU64 seed = 1000 + id;
+    NvU64 queries = 0;
+
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+        NvU64 query = (testNextRandom(&seed) >> 20) % ((NUM_STABLE - 1) * STABLE_STRIDE);
+        NvU64 bound = (query + STABLE_STRIDE - 1) / STABLE_STRIDE * STABLE_STRIDE;
+        NvU64 found_key = ~0ULL;
+        CUradixNode *found = radixConcurrentTreeFindGEQ(&tree, query, &found_key);
+
+        if (found == NULL || found_key < query || found_key > bound) {
+            printf("  FindGEQ(%lu) returned %lu, expected a key in [%lu, %lu]\n",
+                   query, found ? found_key : 0, query, bound);
+            __atomic_store_n(&reader_failed, 1, __ATOMIC_RELEASE);
+            break;
+        }
+        // Interleave with the writer even on machines with few cores
+        if ((++queries & 1023) == 0) {
+            sched_yield();
+        }
+    }
+    reader_queries[id] = queries;
+    return NULL;
+}
+
+int main() {
+    printf("Testing Concurrent Radix Tree Implementation\n");
+    printf("============================================\n");
+
+    CUradixNode *churn[NUM_CHURN] = {0};
+    pthread_t readers[NUM_READERS];
+    NvU64 seed = 7;
+
+    radixConcurrentTreeInit(&tree, 64);
+    for (NvU64 i = 0; i < NUM_STABLE; i++) {
+        radixConcurrentTreeInsert(&tree, &stable_nodes[i], i * STABLE_STRIDE);
+    }
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        pthread_create(&readers[i], NULL, readerThread, (void *)(size_t)i);
+    }
+
+    // Churn non-stable keys (some duplicates of each other) through
+    // heap-allocated nodes. Removed nodes are poisoned and freed right
+    // away, so a reader still walking one would fail or crash.
+    for (int i = 0; i < NUM_WRITES && !__atomic_load_n(&reader_failed, __ATOMIC_ACQUIRE); i++) {
+        NvU64 r = testNextRandom(&seed);
+        int slot = (int)((r >> 33) % NUM_CHURN);
+
+        if (churn[slot]) {
+            radixConcurrentTreeRemove(&tree, churn[slot]);
+            memset(churn[slot], 0xA5, sizeof(CUradixNode));
+            free(churn[slot]);
+            churn[slot] = NULL;
+        }
+        else {
+            NvU64 key = (r >> 20) % (NUM_STABLE * STABLE_STRIDE);
+            if (key % STABLE_STRIDE == 0) {
+                key++;
+            }
+            churn[slot] = (CUradixNode *)malloc(sizeof(CUradixNode));
+            radixConcurrentTreeInsert(&tree, churn[slot], (i & 7) ? key : 1);
+        }
+        if ((i & 63) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+
+    NvU64 total_queries = 0;
+    for (int i = 0; i < NUM_READERS; i++) {
+        pthread_join(readers[i], NULL);
+        total_queries += reader_queries[i];
+    }
+    if (reader_failed) {
+        return -1;
+    }
+    printf("%d writes against %d readers (%lu queries), all results in range\n",
+           NUM_WRITES, NUM_READERS, total_queries);
+
+    // Quiescent tree: the wrapper must agree exactly with radixTreeFindGEQ
+    for (int q = 0; q < 100000; q++) {
+        NvU64 query = (testNextRandom(&seed) >> 20) % (NUM_STABLE * STABLE_STRIDE + 16);
+        NvU64 found_key = 0;
+        CUradixNode *found = radixConcurrentTreeFindGEQ(&tree, query, &found_key);
+        CUradixNode *expected = radixTreeFindGEQ(&tree.tree, query);
+        if (found != expected || (found && found_key != found->key)) {
+            printf("  FindGEQ(%lu) differs from radixTreeFindGEQ\n", query);
+            return -1;
+        }
+    }
+    printf("Quiescent FindGEQ matches radixTreeFindGEQ\n");
+
+    for (int i = 0; i < NUM_CHURN; i++) {
+        if (churn[i]) {
+            radixConcurrentTreeRemove(&tree, churn[i]);
+            free(churn[i]);
+        }
+    }
+    for (NvU64 i = 0; i < NUM_STABLE; i++) {
+        radixConcurrentTreeRemove(&tree, &stable_nodes[i]);
+    }
+    if (!radixTreeEmpty(&tree.tree)) {
+        printf("Tree not empty after removing every key\n");
+        return -1;
+    }
+    radixConcurrentTreeDestroy(&tree);
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
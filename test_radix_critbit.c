@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_critbit.h"
+#include "test_common.h"
+
+#define NUM_KEYS 5000
+
+static CUradixCritbitNode nodes[NUM_KEYS];
+static NvU64 keys[NUM_KEYS];
+static int present[NUM_KEYS];
+static NvU64 seed = 11;
+
+static int checkFindGEQ(CUradixCritbitTree *tree, NvU64 query, int num_keys)
+{
+    int best = testBruteForceGEQ(keys, present, num_keys, query);
+    CUradixCritbitNode *found = radixCritbitTreeFindGEQ(tree, query);
+    if ((best < 0) != (found == NULL) || (found && found->key != keys[best])) {
+        printf("  FindGEQ(%lu) returned the wrong node\n", query);
+        return -1;
+    }
+    return 0;
+}
+
+static int checkRandomFindGEQ(CUradixCritbitTree *tree, int num_queries)
+{
+    for (int q = 0; q < num_queries; q++) {
+        if (checkFindGEQ(tree, testQuery(keys, NUM_KEYS, q, ~0ULL, &seed), NUM_KEYS) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Every branch in use hangs where its parent link says, tests a lower bit
+// than its parent, and has both children; n primaries need n - 1 branches
+static int checkStructure(CUradixCritbitTree *tree, int num_keys)
+{
+    int leaves = 0;
+    int branches = 0;
+
+    for (int i = 0; i < num_keys; i++) {
+        CUradixCritbitBranch *branch = &nodes[i].branch;
+
+        if (!present[i]) {
+            continue;
+        }
+        if (nodes[i].parent_to_self_ptr) {
+            leaves++;
+            if (*nodes[i].parent_to_self_ptr != (CUradixCritbitLink)&nodes[i]) {
+                printf("  Leaf %lu is not where its parent link says\n", nodes[i].key);
+                return -1;
+            }
+        }
+        if (!branch->parent_to_self_ptr) {
+            continue;
+        }
+        branches++;
+        if (*branch->parent_to_self_ptr != ((CUradixCritbitLink)branch | 1) ||
+            branch->child[0] == 0 || branch->child[1] == 0 ||
+            (branch->parent && branch->parent->bit <= branch->bit)) {
+            printf("  Branch of node %d is inconsistent\n", i);
+            return -1;
+        }
+    }
+    if (leaves != 0 && branches != leaves - 1) {
+        printf("  %d leaves but %d branches in use\n", leaves, branches);
+        return -1;
+    }
+    if ((tree->root == 0) != (leaves == 0)) {
+        printf("  Root does not match the number of leaves\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Small trees with hand-picked keys: the structure and every query in
+// [0, 32) are checked after each step. Removed nodes are poisoned so that
+// any leftover reference to them shows up.
+static void insertKey(CUradixCritbitTree *tree, int i, NvU64 key)
+{
+    keys[i] = key;
+    radixCritbitTreeInsert(tree, &nodes[i], key);
+    present[i] = 1;
+}
+
+static void removeKey(int i)
+{
+    radixCritbitTreeRemove(&nodes[i]);
+    present[i] = 0;
+    memset(&nodes[i], 0xA5, sizeof(nodes[i]));
+}
+
+static int checkSmallTree(CUradixCritbitTree *tree, int num_keys, const char *step)
+{
+    if (checkStructure(tree, num_keys) != 0) {
+        printf("  ... after %s\n", step);
+        return -1;
+    }
+    for (NvU64 query = 0; query < 32; query++) {
+        if (checkFindGEQ(tree, query, num_keys) != 0) {
+            printf("  ... after %s\n", step);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int runBranchRelocationTests(void)
+{
+    CUradixCritbitTree tree;
+
+    // 0b1000 puts its branch (bit 3) at the root; 0b1100 then splits its
+    // leaf with a bit 2 branch, so node 1's own branch sits above its leaf's
+    // parent. Removing node 1 retires node 2's branch and must relocate node
+    // 1's branch, still the root, into that storage. Node 2 is then in the
+    // same position under node 3's branch.
+    memset(present, 0, sizeof(present));
+    radixCritbitTreeInit(&tree, 64);
+    insertKey(&tree, 0, 0x0);
+    insertKey(&tree, 1, 0x8);
+    insertKey(&tree, 2, 0xC);
+    insertKey(&tree, 3, 0xE);
+    if (nodes[1].parent != &nodes[2].branch || nodes[2].branch.parent != &nodes[1].branch ||
+        checkSmallTree(&tree, 4, "setup") != 0) {
+        printf("  Unexpected shape for the branch relocation case\n");
+        return -1;
+    }
+    removeKey(1);
+    if (checkSmallTree(&tree, 4, "removing a node whose branch is above its parent") != 0 ||
+        tree.root != ((CUradixCritbitLink)&nodes[2].branch | 1) || nodes[2].branch.bit != 3) {
+        printf("  Root branch was not relocated into the retired storage\n");
+        return -1;
+    }
+    removeKey(2);
+    if (checkSmallTree(&tree, 4, "removing the relocated branch's host") != 0) {
+        return -1;
+    }
+    removeKey(3);
+    removeKey(0);
+    if (!radixCritbitTreeEmpty(&tree)) {
+        printf("  Tree not empty after the branch relocation case\n");
+        return -1;
+    }
+
+    // A primary's branch is its own leaf's parent right after its insert.
+    // Removing the primary hands both leaf and branch to its duplicate, so
+    // the duplicate ends up a child of its own relocated branch.
+    memset(present, 0, sizeof(present));
+    radixCritbitTreeInit(&tree, 64);
+    insertKey(&tree, 0, 0x0);
+    insertKey(&tree, 1, 0x8);
+    insertKey(&tree, 2, 0x8);
+    insertKey(&tree, 3, 0x8);
+    if (nodes[1].parent != &nodes[1].branch) {
+        printf("  Unexpected shape for the duplicate handover case\n");
+        return -1;
+    }
+    removeKey(1);
+    if (checkSmallTree(&tree, 4, "removing a primary whose branch is its parent") != 0 ||
+        nodes[2].parent != &nodes[2].branch || nodes[2].parent_to_self_ptr != &nodes[2].branch.child[1]) {
+        printf("  Duplicate did not take over the primary's leaf and branch\n");
+        return -1;
+    }
+    removeKey(2);
+    if (checkSmallTree(&tree, 4, "removing the new primary") != 0 || nodes[3].parent != &nodes[3].branch) {
+        printf("  Second handover to a duplicate failed\n");
+        return -1;
+    }
+    removeKey(0);
+    if (checkSmallTree(&tree, 4, "removing the other leaf") != 0) {
+        return -1;
+    }
+    removeKey(3);
+    if (!radixCritbitTreeEmpty(&tree)) {
+        printf("  Tree not empty after the duplicate handover case\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Queries whose crit bit against the leaf on their path is 1, i.e. larger
+// than every key sharing their prefix: the answer is the minimum of the
+// deepest child[1] subtree passed over, or NULL if the walk never went left
+static int runFindGEQPastPrefixTests(void)
+{
+    CUradixCritbitTree tree;
+
+    memset(present, 0, sizeof(present));
+    radixCritbitTreeInit(&tree, 64);
+    insertKey(&tree, 0, 0x0);
+    insertKey(&tree, 1, 0x4);
+
+    // 6 follows the root's child[1] to 4 and differs in bit 1: no gt_tree.
+    // 8 differs from 4 above the root's bit, so the walk stops at the root.
+    if (radixCritbitTreeFindGEQ(&tree, 0x6) != NULL || radixCritbitTreeFindGEQ(&tree, 0x8) != NULL ||
+        radixCritbitTreeFindGEQ(&tree, ~0ULL) != NULL || radixCritbitTreeFindGEQ(&tree, 0x5) != NULL) {
+        printf("  FindGEQ above every key with a set crit bit did not return NULL\n");
+        return -1;
+    }
+    // With 0x18 the walk for 6 goes left at bit 4, which provides gt_tree
+    insertKey(&tree, 2, 0x18);
+    if (radixCritbitTreeFindGEQ(&tree, 0x6) != &nodes[2] || checkSmallTree(&tree, 3, "adding 0x18") != 0) {
+        printf("  FindGEQ with a set crit bit missed the subtree passed over\n");
+        return -1;
+    }
+    removeKey(2);
+    removeKey(1);
+    removeKey(0);
+    return 0;
+}
+
+int main() {
+    printf("Testing Crit-Bit Radix Tree Implementation\n");
+    printf("==========================================\n");
+
+    CUradixCritbitTree tree;
+    radixCritbitTreeInit(&tree, 64);
+    if (!radixCritbitTreeEmpty(&tree) || radixCritbitTreeFindGEQ(&tree, 0) != NULL) {
+        printf("New tree is not empty\n");
+        return -1;
+    }
+    printf("Node size: %zu bytes (%zu for the embedded branch)\n",
+           sizeof(CUradixCritbitNode), sizeof(CUradixCritbitBranch));
+
+    if (runBranchRelocationTests() != 0 || runFindGEQPastPrefixTests() != 0) {
+        return -1;
+    }
+    printf("Branch relocation, duplicate handover and FindGEQ past a prefix verified\n");
+
+    testFillKeys(keys, NUM_KEYS, ~0ULL, &seed);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        radixCritbitTreeInsert(&tree, &nodes[i], keys[i]);
+        present[i] = 1;
+    }
+    if (checkStructure(&tree, NUM_KEYS) != 0 || checkRandomFindGEQ(&tree, 5000) != 0) {
+        return -1;
+    }
+    printf("Inserted %d keys, structure and FindGEQ verified\n", NUM_KEYS);
+
+    for (int i = 0; i < NUM_KEYS; i++) {
+        int index = testScatteredIndex(i, NUM_KEYS);
+        if (index % 2 == 0) {
+            removeKey(index);
+        }
+    }
+    if (checkStructure(&tree, NUM_KEYS) != 0 || checkRandomFindGEQ(&tree, 5000) != 0) {
+        return -1;
+    }
+    printf("Removed half of the keys, structure and FindGEQ verified\n");
+
+    // Reinsert, then remove everything
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (!present[i]) {
+            radixCritbitTreeInsert(&tree, &nodes[i], keys[i]);
+            present[i] = 1;
+        }
+    }
+    if (checkStructure(&tree, NUM_KEYS) != 0 || checkRandomFindGEQ(&tree, 2000) != 0) {
+        return -1;
+    }
+    for (int i = NUM_KEYS - 1; i >= 0; i--) {
+        radixCritbitTreeRemove(&nodes[i]);
+        present[i] = 0;
+        if (i % 1000 == 0 && (checkStructure(&tree, NUM_KEYS) != 0 || checkRandomFindGEQ(&tree, 200) != 0)) {
+            return -1;
+        }
+    }
+    if (!radixCritbitTreeEmpty(&tree) || radixCritbitTreeFindGEQ(&tree, 0) != NULL) {
+        printf("Tree not empty after removing every key\n");
+        return -1;
+    }
+    printf("Reinsertion and full removal verified\n");
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_interval.h"
+#include "test_common.h"
+
+#define NUM_INTERVALS 3000
+
+static CUradixIntervalNode nodes[NUM_INTERVALS];
+static int present[NUM_INTERVALS];
+static NvU64 seed = 42;
+
+static int overlaps(const CUradixIntervalNode *node, NvU64 first, NvU64 last)
+{
+    return node->start <= last && node->end > first;
+}
+
+// Reference answer: lowest start among the present intervals overlapping
+// [first, last], or -1
+static int bruteForceFirst(NvU64 first, NvU64 last, int *count)
+{
+    int best = -1;
+    *count = 0;
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        if (present[i] && overlaps(&nodes[i], first, last)) {
+            (*count)++;
+            if (best < 0 || nodes[i].start < nodes[best].start) {
+                best = i;
+            }
+        }
+    }
+    return best;
+}
+
+typedef struct {
+    NvU64 first;
+    NvU64 last;
+    NvU64 last_start;
+    int count;
+    int errors;
+} VisitState;
+
+static int visitOverlap(CUradixIntervalNode *node, void *data)
+{
+    VisitState *state = (VisitState *)data;
+    if (!overlaps(node, state->first, state->last) || (state->count > 0 && node->start < state->last_start)) {
+        state->errors++;
+    }
+    state->last_start = node->start;
+    state->count++;
+    return 0;
+}
+
+static int checkQueries(CUradixIntervalTree *tree, int num_queries)
+{
+    for (int q = 0; q < num_queries; q++) {
+        NvU64 first = (testNextRandom(&seed) >> 16) % 1100000;
+        NvU64 length = (q % 4 == 0) ? 1 : 1 + (testNextRandom(&seed) >> 16) % 5000;
+        NvU64 last = first + length - 1;
+        int count;
+        int best = bruteForceFirst(first, last, &count);
+
+        CUradixIntervalNode *found = (length == 1) ? radixIntervalTreeFindContaining(tree, first)
+                                                   : radixIntervalTreeFindOverlap(tree, first, length);
+        if ((best < 0) != (found == NULL) ||
+            (found && (found->start != nodes[best].start || !overlaps(found, first, last)))) {
+            printf("  Overlap query [%lu, %lu] returned the wrong interval\n", first, last);
+            return -1;
+        }
+
+        VisitState state = {first, last, 0, 0, 0};
+        radixIntervalTreeForEachOverlap(tree, first, length, visitOverlap, &state);
+        if (state.errors || state.count != count) {
+            printf("  ForEachOverlap [%lu, %lu] visited %d of %d intervals (%d errors)\n",
+                   first, last, state.count, count, state.errors);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    printf("Testing Radix Interval Tree Implementation\n");
+    printf("==========================================\n");
+
+    CUradixIntervalTree tree;
+    radixIntervalTreeInit(&tree, 64);
+
+    // A handful of fixed intervals first
+    radixIntervalTreeInsert(&tree, &nodes[0], 100, 50);   // [100, 150)
+    radixIntervalTreeInsert(&tree, &nodes[1], 120, 10);   // [120, 130)
+    radixIntervalTreeInsert(&tree, &nodes[2], 10, 1000);  // [10, 1010)
+    radixIntervalTreeInsert(&tree, &nodes[3], 2000, 1);   // [2000, 2001)
+    if (radixIntervalTreeFindContaining(&tree, 125) != &nodes[2] ||
+        radixIntervalTreeFindOverlap(&tree, 1010, 990) != NULL ||
+        radixIntervalTreeFindContaining(&tree, 2000) != &nodes[3] ||
+        radixIntervalTreeFindContaining(&tree, 5) != NULL) {
+        printf("Fixed interval queries failed\n");
+        return -1;
+    }
+    radixIntervalTreeRemove(&nodes[2]);
+    if (radixIntervalTreeFindContaining(&tree, 125) != &nodes[0] ||
+        radixIntervalTreeFindContaining(&tree, 500) != NULL) {
+        printf("Queries after removal failed\n");
+        return -1;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (i != 2) {
+            radixIntervalTreeRemove(&nodes[i]);
+        }
+    }
+    if (!radixIntervalTreeEmpty(&tree)) {
+        printf("Tree not empty after removing every interval\n");
+        return -1;
+    }
+    printf("Fixed intervals verified\n");
+
+    // Random intervals over a ~1M address range; every 8th start is reused
+    // so that duplicate lists are exercised
+    printf("\nInserting %d random intervals...\n", NUM_INTERVALS);
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        NvU64 start = (i % 8 == 7) ? nodes[i / 2].start : (testNextRandom(&seed) >> 16) % 1000000;
+        NvU64 length = 1 + ((i % 16 == 0) ? (testNextRandom(&seed) >> 16) % 50000 : (testNextRandom(&seed) >> 16) % 2000);
+        radixIntervalTreeInsert(&tree, &nodes[i], start, length);
+        present[i] = 1;
+    }
+    if (checkQueries(&tree, 3000) != 0) {
+        return -1;
+    }
+    printf("Overlap and stabbing queries match brute force\n");
+
+    // Remove two thirds in scattered order, including primaries with
+    // duplicates, and check again
+    printf("\nRemoving intervals...\n");
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        int index = testScatteredIndex(i, NUM_INTERVALS);
+        if (index % 3 != 0) {
+            radixIntervalTreeRemove(&nodes[index]);
+            present[index] = 0;
+        }
+    }
+    if (checkQueries(&tree, 3000) != 0) {
+        return -1;
+    }
+    printf("Queries after removal match brute force\n");
+
+    // Reinsert the removed intervals, then remove everything
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        if (!present[i]) {
+            radixIntervalTreeInsert(&tree, &nodes[i], nodes[i].start, nodes[i].end - nodes[i].start);
+            present[i] = 1;
+        }
+    }
+    if (checkQueries(&tree, 1000) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        radixIntervalTreeRemove(&nodes[i]);
+        present[i] = 0;
+    }
+    if (!radixIntervalTreeEmpty(&tree)) {
+        printf("Tree not empty after removing every interval\n");
+        return -1;
+    }
+    printf("Reinsertion and full removal verified\n");
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
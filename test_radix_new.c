@@ -86,6 +86,198 @@ int main() {
     treeDestroy(&tree);
     printf("\nTree destroyed successfully\n");
     
+    // Test order statistics
+    printf("\nTesting rank/select/countRange...\n");
+    WideRadixTree countedTree;
+    treeInitWithFlags(&countedTree, 64, 8, TREE_FLAG_COUNTS);
+    
+    // Spread keys over several levels and blocks; the array stays sorted
+    uint64_t sortedKeys[200];
+    int numSorted = 0;
+    for (int i = 0; i < 200; i++) {
+        sortedKeys[numSorted++] = (uint64_t)i * 0x10203ULL + (uint64_t)(i % 7) * 0x1000000000ULL * (i / 50);
+    }
+    for (int i = 1; i < numSorted; i++) {
+        for (int j = i; j > 0 && sortedKeys[j - 1] > sortedKeys[j]; j--) {
+            uint64_t tmp = sortedKeys[j];
+            sortedKeys[j] = sortedKeys[j - 1];
+            sortedKeys[j - 1] = tmp;
+        }
+    }
+    for (int i = numSorted - 1; i >= 0; i--) {
+        uint64_t existing;
+        treeInsertOrReturnExisting(&countedTree, sortedKeys[i], i + 1, &existing);
+    }
+    
+    int orderErrors = 0;
+    if (treeCount(&countedTree) != (uint64_t)numSorted) {
+        printf("treeCount returned %lu, expected %d\n", treeCount(&countedTree), numSorted);
+        orderErrors++;
+    }
+    for (int i = 0; i < numSorted; i++) {
+        uint64_t selected;
+        if (treeRank(&countedTree, sortedKeys[i]) != (uint64_t)i ||
+            treeRank(&countedTree, sortedKeys[i] + 1) != (uint64_t)(i + 1) ||
+            treeSelect(&countedTree, i, &selected) != 0 || selected != sortedKeys[i]) {
+            printf("Order statistics wrong for key %lu (index %d)\n", sortedKeys[i], i);
+            orderErrors++;
+        }
+    }
+    uint64_t unused;
+    if (treeSelect(&countedTree, numSorted, &unused) != -1) {
+        printf("treeSelect past the end should fail\n");
+        orderErrors++;
+    }
+    if (treeCountRange(&countedTree, sortedKeys[10], sortedKeys[150]) != 140) {
+        printf("treeCountRange returned %lu, expected 140\n",
+               treeCountRange(&countedTree, sortedKeys[10], sortedKeys[150]));
+        orderErrors++;
+    }
+    
+    // Remove every third key and check the counters follow
+    for (int i = 0; i < numSorted; i += 3) {
+        treeRemove(&countedTree, sortedKeys[i]);
+    }
+    uint64_t expectedRank = 0;
+    for (int i = 0; i < numSorted; i++) {
+        if (i % 3 == 0) {
+            continue;
+        }
+        uint64_t selected;
+        if (treeRank(&countedTree, sortedKeys[i]) != expectedRank ||
+            treeSelect(&countedTree, expectedRank, &selected) != 0 || selected != sortedKeys[i]) {
+            printf("Order statistics wrong after removal for key %lu\n", sortedKeys[i]);
+            orderErrors++;
+        }
+        expectedRank++;
+    }
+    if (treeCount(&countedTree) != expectedRank) {
+        printf("treeCount after removal returned %lu, expected %lu\n", treeCount(&countedTree), expectedRank);
+        orderErrors++;
+    }
+    
+    if (orderErrors == 0) {
+        printf("Rank, select and countRange agree with sorted reference (%lu keys left)\n", expectedRank);
+    }
+    treeDestroy(&countedTree);
+    if (orderErrors) {
+        return -1;
+    }
+    
+    // Test multimap mode
+    printf("\nTesting multimap (duplicate keys)...\n");
+    WideRadixTree multiTree;
+    treeInitWithFlags(&multiTree, 64, 8, TREE_FLAG_MULTI | TREE_FLAG_COUNTS);
+    int multiErrors = 0;
+    
+    // Key 500 spills into several overflow chunks, key 600 stays inline
+    for (uint64_t v = 1; v <= 40; v++) {
+        treeInsertDuplicate(&multiTree, 500, v);
+    }
+    treeInsertDuplicate(&multiTree, 600, 7);
+    treeInsertDuplicate(&multiTree, 600, 8);
+    
+    uint64_t allValues[64];
+    size_t numValues = treeFindAll(&multiTree, 500, allValues, 64);
+    uint64_t valueSum = 0;
+    for (size_t i = 0; i < numValues; i++) {
+        valueSum += allValues[i];
+    }
+    if (numValues != 40 || valueSum != 820) {
+        printf("treeFindAll(500) returned %zu values with sum %lu\n", numValues, valueSum);
+        multiErrors++;
+    }
+    if (treeFind(&multiTree, 500) != 1 || treeFindGEQ(&multiTree, 501) != 7 || treeCount(&multiTree) != 2) {
+        printf("Single-value lookups on multimap returned unexpected results\n");
+        multiErrors++;
+    }
+    
+    // Remove specific values from the middle, the inline part and the tail
+    uint64_t toRemove[] = {20, 1, 40, 9, 2};
+    for (int i = 0; i < 5; i++) {
+        if (treeRemoveValue(&multiTree, 500, toRemove[i]) != 0) {
+            printf("treeRemoveValue(500, %lu) failed\n", toRemove[i]);
+            multiErrors++;
+        }
+        valueSum -= toRemove[i];
+    }
+    if (treeRemoveValue(&multiTree, 500, 20) != -1) {
+        printf("Removing an absent value should fail\n");
+        multiErrors++;
+    }
+    numValues = treeFindAll(&multiTree, 500, allValues, 64);
+    uint64_t remainingSum = 0;
+    for (size_t i = 0; i < numValues; i++) {
+        remainingSum += allValues[i];
+    }
+    if (numValues != 35 || remainingSum != valueSum) {
+        printf("After removals treeFindAll(500) returned %zu values with sum %lu\n", numValues, remainingSum);
+        multiErrors++;
+    }
+    
+    // treeRemove pops one value at a time until the key disappears
+    for (size_t i = 0; i < 35; i++) {
+        treeRemove(&multiTree, 500);
+    }
+    if (treeFindAll(&multiTree, 500, allValues, 64) != 0 || treeCount(&multiTree) != 1 ||
+        treeFindAll(&multiTree, 600, allValues, 64) != 2) {
+        printf("Key 500 should be gone and key 600 intact\n");
+        multiErrors++;
+    }
+    treeDestroy(&multiTree);
+    
+    if (multiErrors) {
+        return -1;
+    }
+    printf("Multimap insert, find-all and remove-one work correctly\n");
+    
+    // Test inline payloads
+    printf("\nTesting inline payloads...\n");
+    typedef struct {
+        uint64_t start;
+        uint64_t length;
+        uint64_t flags;
+    } RangeDescriptor;
+    WideRadixTree payloadTree;
+    if (treeInitWithValueSize(&payloadTree, 64, 8, 12, 0) != -1) {
+        printf("Value sizes that are not a multiple of 8 should be rejected\n");
+        return -1;
+    }
+    treeInitWithValueSize(&payloadTree, 64, 8, sizeof(RangeDescriptor), 0);
+    for (uint64_t i = 1; i <= 100; i++) {
+        RangeDescriptor range = { i << 12, i * 3, i ^ 0x55 };
+        void *slot;
+        if (treeInsertPayload(&payloadTree, i << 12, &range, &slot) != 0) {
+            printf("Failed to insert payload for key %lu\n", i << 12);
+            return -1;
+        }
+    }
+    RangeDescriptor other = { 0, 0, 0 };
+    void *existingSlot;
+    if (treeInsertPayload(&payloadTree, 5 << 12, &other, &existingSlot) != 1 ||
+        ((RangeDescriptor *)existingSlot)->length != 15) {
+        printf("Re-inserting a key should return the existing payload\n");
+        return -1;
+    }
+    for (uint64_t i = 1; i <= 100; i++) {
+        RangeDescriptor *range = (RangeDescriptor *)treeFindPayload(&payloadTree, i << 12);
+        if (!range || range->start != (i << 12) || range->length != i * 3 || range->flags != (i ^ 0x55)) {
+            printf("Payload lookup failed for key %lu\n", i << 12);
+            return -1;
+        }
+    }
+    RangeDescriptor *geq = (RangeDescriptor *)treeFindGEQPayload(&payloadTree, (7 << 12) + 1);
+    RangeDescriptor removedRange;
+    if (!geq || geq->start != (8 << 12) ||
+        treeRemovePayload(&payloadTree, 8 << 12, &removedRange) != 0 || removedRange.length != 24 ||
+        treeFindPayload(&payloadTree, 8 << 12) != NULL ||
+        treeRemovePayload(&payloadTree, 8 << 12, &removedRange) != -1) {
+        printf("Payload GEQ/removal returned unexpected results\n");
+        return -1;
+    }
+    treeDestroy(&payloadTree);
+    printf("Inline 24-byte payloads work correctly\n");
+    
     printf("\nAll tests completed!\n");
     return 0;
 }
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <random>
+#include "radix_new.hpp"
+
+template <unsigned KeyBits, unsigned StrideBits>
+static int runTest(const char* name, int numKeys) {
+    WideRadix<KeyBits, StrideBits, uint64_t> tree;
+    std::map<uint64_t, uint64_t> reference;
+    std::mt19937_64 gen(42);
+    uint64_t keyMask = (KeyBits == 64) ? ~0ULL : ((1ULL << KeyBits) - 1);
+
+    printf("Testing WideRadix<%u, %u> (%s): %u levels\n", KeyBits, StrideBits, name,
+           WideRadix<KeyBits, StrideBits, uint64_t>::kNumLevels);
+
+    for (int i = 0; i < numKeys; i++) {
+        // Mix clustered and random keys so that blocks are shared
+        uint64_t key = ((i & 1) ? gen() : (uint64_t)(i * 3)) & keyMask;
+        uint64_t* existing;
+        if (tree.insertOrReturnExisting(key, (uint64_t)i, &existing) != 0) {
+            printf("Failed to insert key %lu\n", key);
+            return -1;
+        }
+        bool inserted = reference.emplace(key, (uint64_t)i).second;
+        if (inserted != (existing == nullptr)) {
+            printf("Insert of key %lu disagrees with reference\n", key);
+            return -1;
+        }
+    }
+
+    for (const auto& kv : reference) {
+        uint64_t* found = tree.find(kv.first);
+        if (!found || *found != kv.second) {
+            printf("Lookup failed for key %lu\n", kv.first);
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < numKeys; i++) {
+        uint64_t query = ((i & 1) ? gen() : (uint64_t)(i * 3 + 1)) & keyMask;
+        auto it = reference.lower_bound(query);
+        uint64_t foundKey;
+        uint64_t* found = tree.findGEQ(query, &foundKey);
+        if ((it == reference.end()) != (found == nullptr) ||
+            (found && (foundKey != it->first || *found != it->second))) {
+            printf("findGEQ(%lu) disagrees with reference\n", query);
+            return -1;
+        }
+    }
+
+    // Remove every other key and verify the rest survive
+    size_t numVerified = reference.size();
+    int removed = 0;
+    for (auto it = reference.begin(); it != reference.end(); removed++) {
+        if (removed & 1) {
+            ++it;
+            continue;
+        }
+        uint64_t value;
+        if (!tree.remove(it->first, &value) || value != it->second || tree.find(it->first)) {
+            printf("Removal failed for key %lu\n", it->first);
+            return -1;
+        }
+        it = reference.erase(it);
+    }
+    for (const auto& kv : reference) {
+        uint64_t* found = tree.find(kv.first);
+        if (!found || *found != kv.second) {
+            printf("Lookup after removal failed for key %lu\n", kv.first);
+            return -1;
+        }
+    }
+    for (const auto& kv : reference) {
+        tree.remove(kv.first);
+    }
+    if (!tree.empty()) {
+        printf("Tree not empty after removing all keys\n");
+        return -1;
+    }
+
+    printf("  %zu keys verified\n", numVerified);
+    return 0;
+}
+
+int main() {
+    printf("Testing Radix New Template Implementation\n");
+    printf("=========================================\n");
+
+    if (runTest<56, 8>("same shape as treeInit(64, 8)", 20000) != 0 ||
+        runTest<64, 8>("full 64-bit keys", 20000) != 0 ||
+        runTest<32, 4>("16-way nodes", 20000) != 0 ||
+        runTest<20, 3>("partial top level", 5000) != 0) {
+        return -1;
+    }
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_stride.h"
+#include "test_common.h"
+
+#define NUM_KEYS 5000
+
+static CUradixStrideNode nodes[NUM_KEYS];
+static NvU64 keys[NUM_KEYS];
+static int present[NUM_KEYS];
+static NvU64 seed = 11;
+
+static int checkFindGEQ(CUradixStrideTree *tree, NvU64 key_mask, int num_queries)
+{
+    for (int q = 0; q < num_queries; q++) {
+        NvU64 query = testQuery(keys, NUM_KEYS, q, key_mask, &seed);
+        int best = testBruteForceGEQ(keys, present, NUM_KEYS, query);
+        CUradixStrideNode *found = radixStrideTreeFindGEQ(tree, query);
+        if ((best < 0) != (found == NULL) || (found && found->key != keys[best])) {
+            printf("  FindGEQ(%lu) returned the wrong node\n", query);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Insert, query, remove half, query, remove the rest
+static int runTest(NvU32 key_bits)
+{
+    CUradixStrideTree tree;
+    NvU64 key_mask = (key_bits == 64) ? ~0ULL : (1ULL << key_bits) - 1;
+
+    printf("Testing %u-way tree with %u-bit keys\n", RADIX_STRIDE_FANOUT, key_bits);
+    radixStrideTreeInit(&tree, key_bits);
+
+    testFillKeys(keys, NUM_KEYS, key_mask, &seed);
+    for (int i = 0; i < NUM_KEYS; i++) {
+        radixStrideTreeInsert(&tree, &nodes[i], keys[i]);
+        present[i] = 1;
+    }
+    if (checkFindGEQ(&tree, key_mask, 4000) != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < NUM_KEYS; i++) {
+        int index = testScatteredIndex(i, NUM_KEYS);
+        if (index % 2 == 0) {
+            radixStrideTreeRemove(&nodes[index]);
+            present[index] = 0;
+        }
+    }
+    if (checkFindGEQ(&tree, key_mask, 4000) != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < NUM_KEYS; i++) {
+        if (present[i]) {
+            radixStrideTreeRemove(&nodes[i]);
+            present[i] = 0;
+        }
+    }
+    if (!radixStrideTreeEmpty(&tree)) {
+        printf("  Tree not empty after removing every key\n");
+        return -1;
+    }
+    printf("  FindGEQ matches brute force through insertion and removal\n");
+    return 0;
+}
+
+// When key_bits is not a multiple of RADIX_STRIDE_BITS the root's digit is
+// only partly inside the key. Keys that differ only in those top bits must
+// still land under distinct root children and order correctly, with and
+// without equal low bits elsewhere in the tree.
+static int runPartialTopDigitTest(NvU32 key_bits)
+{
+    CUradixStrideTree tree;
+    NvU64 key_mask = (1ULL << key_bits) - 1;
+    int num_keys = 0;
+
+    radixStrideTreeInit(&tree, key_bits);
+    NvU32 top_bits = key_bits - tree.top_shift;
+    printf("Testing %u-bit keys differing only in the %u-bit top digit\n", key_bits, top_bits);
+    if (top_bits == 0 || top_bits >= RADIX_STRIDE_BITS) {
+        printf("  Top digit is not partial for this stride\n");
+        return -1;
+    }
+
+    // Every top-digit value over a few low patterns, including all-zero and
+    // all-one low bits, inserted highest top digit first
+    NvU64 low_mask = (1ULL << tree.top_shift) - 1;
+    NvU64 lows[4] = { 0, 1, testNextRandom(&seed) & low_mask, low_mask };
+    for (int l = 0; l < 4; l++) {
+        for (NvU64 digit = 1ULL << top_bits; digit-- > 0;) {
+            keys[num_keys] = (digit << tree.top_shift) | lows[l];
+            radixStrideTreeInsert(&tree, &nodes[num_keys], keys[num_keys]);
+            present[num_keys] = 1;
+            num_keys++;
+        }
+    }
+
+    for (int removed = 0; removed <= num_keys; removed++) {
+        for (int i = 0; i < num_keys; i++) {
+            NvU64 queries[3] = { keys[i], (keys[i] + 1) & key_mask, keys[i] & ~low_mask };
+            for (int q = 0; q < 3; q++) {
+                int best = testBruteForceGEQ(keys, present, num_keys, queries[q]);
+                CUradixStrideNode *found = radixStrideTreeFindGEQ(&tree, queries[q]);
+                if ((best < 0) != (found == NULL) || (found && found->key != keys[best])) {
+                    printf("  FindGEQ(%lx) returned the wrong node\n", queries[q]);
+                    return -1;
+                }
+            }
+        }
+        if (removed < num_keys) {
+            int index = testScatteredIndex(removed, num_keys);
+            radixStrideTreeRemove(&nodes[index]);
+            present[index] = 0;
+        }
+    }
+    if (!radixStrideTreeEmpty(&tree)) {
+        printf("  Tree not empty after removing every key\n");
+        return -1;
+    }
+    printf("  FindGEQ matches brute force through insertion and removal\n");
+    return 0;
+}
+
+int main() {
+    printf("Testing Stride Radix Tree Implementation\n");
+    printf("========================================\n");
+
+    // 63 bits is not a whole number of digits for any stride above 1
+    if (runTest(64) != 0 || runTest(63) != 0 || runTest(20) != 0) {
+        return -1;
+    }
+    // A partial top digit needs a key width that isn't a multiple of the
+    // stride: 63 and 21 bits for 2-, 4- and 8-bit strides
+    if (runPartialTopDigitTest(63) != 0 || runPartialTopDigitTest(21) != 0) {
+        return -1;
+    }
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "va_allocator.h"
+#include "test_common.h"
+
+#define VA_BASE (1ULL << 32)
+#define VA_SIZE (128ULL << 20)
+#define MAX_LIVE 512
+#define NUM_OPS 20000
+
+static NvU64 live_addr[MAX_LIVE];
+static NvU64 live_size[MAX_LIVE];
+static int num_live;
+static NvU64 seed = 5;
+
+static CUvaFreeRange *rangeOf(CUradixNode *addr_node)
+{
+    return (CUvaFreeRange *)((char *)addr_node - offsetof(CUvaFreeRange, addr_node));
+}
+
+// Free ranges in address order must be disjoint and never touch (they'd
+// have been coalesced), and add up to the allocator's counters
+static int checkFreeRanges(CUvaAllocator *va)
+{
+    NvU64 total = 0;
+    NvU64 count = 0;
+    NvU64 last_end = 0;
+
+    for (CUradixNode *node = radixTreeFindGEQ(&va->by_addr, 0); node; node = radixTreeNext(node)) {
+        CUvaFreeRange *range = rangeOf(node);
+        NvU64 start = range->addr_node.key;
+        NvU64 length = range->size_node.key;
+
+        if (length == 0 || start < VA_BASE || start + length > VA_BASE + VA_SIZE ||
+            (count > 0 && start <= last_end)) {
+            printf("  Free range [%lx, %lx) overlaps, touches or lies outside\n", start, start + length);
+            return -1;
+        }
+        total += length;
+        count++;
+        last_end = start + length;
+    }
+    if (total != va->free_bytes || count != va->num_free_ranges) {
+        printf("  Free ranges add up to %lu bytes in %lu ranges, counters say %lu in %lu\n",
+               total, count, va->free_bytes, va->num_free_ranges);
+        return -1;
+    }
+    return 0;
+}
+
+// Smallest free range that fits size at alignment, by brute force; 0 if none
+static NvU64 bestFitLength(CUvaAllocator *va, NvU64 size, NvU64 alignment)
+{
+    NvU64 best = 0;
+
+    for (CUradixNode *node = radixTreeFindGEQ(&va->by_addr, 0); node; node = radixTreeNext(node)) {
+        CUvaFreeRange *range = rangeOf(node);
+        NvU64 start = range->addr_node.key;
+        NvU64 length = range->size_node.key;
+        NvU64 aligned = (start + alignment - 1) & ~(alignment - 1);
+
+        if (aligned + size <= start + length && (best == 0 || length < best)) {
+            best = length;
+        }
+    }
+    return best;
+}
+
+// Length of the free range holding addr as its lowest aligned address
+static NvU64 fittingRangeLength(CUvaAllocator *va, NvU64 addr, NvU64 size, NvU64 alignment)
+{
+    for (CUradixNode *node = radixTreeFindGEQ(&va->by_addr, 0); node; node = radixTreeNext(node)) {
+        CUvaFreeRange *range = rangeOf(node);
+        NvU64 start = range->addr_node.key;
+        NvU64 length = range->size_node.key;
+
+        if (addr == ((start + alignment - 1) & ~(alignment - 1)) && addr + size <= start + length) {
+            return length;
+        }
+    }
+    return 0;
+}
+
+// An allocator whose range ends at the top of the address space: blocks
+// carved from and freed at ~0ULL - size + 1 must coalesce in either order
+#define TOP_SIZE (1ULL << 20)
+#define TOP_BLOCK 4096ULL
+
+static int checkWholeTopRange(CUvaAllocator *va, const char *step)
+{
+    CUradixNode *node = radixTreeFindGEQ(&va->by_addr, 0);
+
+    if (va->num_free_ranges != 1 || va->free_bytes != TOP_SIZE || node == NULL ||
+        node->key != ~0ULL - TOP_SIZE + 1 || rangeOf(node)->size_node.key != TOP_SIZE) {
+        printf("  Free ranges did not coalesce back into one after %s\n", step);
+        return -1;
+    }
+    return 0;
+}
+
+static int runTopOfAddressSpaceTest(void)
+{
+    CUvaAllocator va;
+    NvU64 low;
+    NvU64 top;
+
+    if (vaAllocatorInit(&va, ~0ULL - TOP_SIZE + 1, TOP_SIZE) != 0) {
+        printf("  Failed to initialize an allocator at the top of the address space\n");
+        return -1;
+    }
+    for (int order = 0; order < 2; order++) {
+        if (vaAllocatorAlloc(&va, TOP_SIZE - TOP_BLOCK, 1, &low) != 0 ||
+            vaAllocatorAlloc(&va, TOP_BLOCK, TOP_BLOCK, &top) != 0 ||
+            low != ~0ULL - TOP_SIZE + 1 || top != ~0ULL - TOP_BLOCK + 1 || va.num_free_ranges != 0) {
+            printf("  Allocations did not fill the range up to the top\n");
+            return -1;
+        }
+        // Merging into next from below, or into prev up to the top
+        if (order == 0) {
+            vaAllocatorFree(&va, top, TOP_BLOCK);
+            vaAllocatorFree(&va, low, TOP_SIZE - TOP_BLOCK);
+        }
+        else {
+            vaAllocatorFree(&va, low, TOP_SIZE - TOP_BLOCK);
+            vaAllocatorFree(&va, top, TOP_BLOCK);
+        }
+        if (checkWholeTopRange(&va, order == 0 ? "freeing the top block first" : "freeing the top block last") != 0) {
+            return -1;
+        }
+    }
+
+    // An alignment whose rounding would wrap past the top must not fit, and
+    // a split that leaves a tail ending at the top must still coalesce
+    if (vaAllocatorAlloc(&va, TOP_BLOCK, 1ULL << 63, &top) == 0 ||
+        vaAllocatorAlloc(&va, TOP_BLOCK, 1, &low) != 0 ||
+        vaAllocatorAlloc(&va, TOP_BLOCK, TOP_SIZE / 2, &top) != 0 || top != ~0ULL - TOP_SIZE / 2 + 1 ||
+        va.num_free_ranges != 2) {
+        printf("  Aligned allocation near the top did not split as expected\n");
+        return -1;
+    }
+    vaAllocatorFree(&va, top, TOP_BLOCK);
+    vaAllocatorFree(&va, low, TOP_BLOCK);
+    if (checkWholeTopRange(&va, "freeing a block split from the middle") != 0) {
+        return -1;
+    }
+    vaAllocatorDestroy(&va);
+    return 0;
+}
+
+int main() {
+    printf("Testing VA Range Allocator\n");
+    printf("==========================\n");
+
+    CUvaAllocator va;
+    if (vaAllocatorInit(&va, VA_BASE, VA_SIZE) != 0) {
+        printf("Failed to initialize allocator\n");
+        return -1;
+    }
+
+    int allocs = 0;
+    int failures = 0;
+    for (int op = 0; op < NUM_OPS; op++) {
+        NvU64 r = testNextRandom(&seed);
+
+        if (num_live < MAX_LIVE && (num_live == 0 || (r & 3) != 0)) {
+            // Page multiples mostly, some odd sizes; alignments 1 byte to 2 MB
+            NvU64 size = ((r >> 8) & 7) ? (((r >> 12) % 128) + 1) << 12 : ((r >> 12) % 100000) + 1;
+            NvU64 alignment = 1ULL << ((r >> 40) % 22);
+            NvU64 expected = bestFitLength(&va, size, alignment);
+            NvU64 addr;
+
+            if (vaAllocatorAlloc(&va, size, alignment, &addr) != 0) {
+                if (expected != 0) {
+                    printf("  Alloc(%lu, %lu) failed although a range fits\n", size, alignment);
+                    return -1;
+                }
+                failures++;
+                continue;
+            }
+            if (expected == 0) {
+                printf("  Alloc(%lu, %lu) succeeded although no range fits\n", size, alignment);
+                return -1;
+            }
+
+            // Undo it to see which range it came from: that must be a best
+            // fit. Redoing may pick another range of the same length.
+            vaAllocatorFree(&va, addr, size);
+            if (fittingRangeLength(&va, addr, size, alignment) != expected) {
+                printf("  Alloc(%lu, %lu) did not take a best-fit range\n", size, alignment);
+                return -1;
+            }
+            if (vaAllocatorAlloc(&va, size, alignment, &addr) != 0 || (addr & (alignment - 1)) != 0) {
+                printf("  Alloc(%lu, %lu) failed or misaligned after an undo\n", size, alignment);
+                return -1;
+            }
+            for (int i = 0; i < num_live; i++) {
+                if (addr < live_addr[i] + live_size[i] && live_addr[i] < addr + size) {
+                    printf("  Alloc(%lu, %lu) overlaps a live allocation\n", size, alignment);
+                    return -1;
+                }
+            }
+            live_addr[num_live] = addr;
+            live_size[num_live] = size;
+            num_live++;
+            allocs++;
+        }
+        else {
+            int index = (int)((r >> 16) % num_live);
+            vaAllocatorFree(&va, live_addr[index], live_size[index]);
+            num_live--;
+            live_addr[index] = live_addr[num_live];
+            live_size[index] = live_size[num_live];
+        }
+
+        if (op % 100 == 0 && checkFreeRanges(&va) != 0) {
+            return -1;
+        }
+    }
+    if (checkFreeRanges(&va) != 0) {
+        return -1;
+    }
+    printf("%d allocations (%d did not fit), %d live, %lu free ranges\n",
+           allocs, failures, num_live, va.num_free_ranges);
+
+    // Freeing everything must coalesce back into a single range
+    while (num_live > 0) {
+        num_live--;
+        vaAllocatorFree(&va, live_addr[num_live], live_size[num_live]);
+    }
+    if (checkFreeRanges(&va) != 0 || va.num_free_ranges != 1 || va.free_bytes != VA_SIZE ||
+        vaAllocatorLargestFree(&va) != VA_SIZE) {
+        printf("Free ranges did not coalesce back into one\n");
+        return -1;
+    }
+    printf("All frees coalesced into one %lu-byte range\n", (NvU64)VA_SIZE);
+
+    vaAllocatorDestroy(&va);
+
+    if (runTopOfAddressSpaceTest() != 0) {
+        return -1;
+    }
+    printf("Allocations ending at the top of the address space free and coalesce\n");
+
+    printf("\nAll tests completed!\n");
+    return 0;
+}
@@ -1,7 +1,10 @@
+// The checks below rely on assert() even in Release builds
+#undef NDEBUG
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include "wide_radix.h"
+#include "test_common.h"
 
 int main() {
     printf("Testing Wide Radix Tree Implementation\n");
@@ -84,6 +87,193 @@ int main() {
     wide_radix_destroy(&empty_tree);
     //wide_radix_destroy(&tree);
     
+    printf("4. Testing node growth...\n");
+    
+    // Dense low bytes fill nodes up to all 256 children; inserts in shuffled order
+    wide_radix_tree_t dense_tree;
+    wide_radix_init(&dense_tree, 64);
+    for (NvU64 i = 0; i < 2048; i++) {
+        NvU64 key = (i * 997) % 2048;
+        assert(wide_radix_insert(&dense_tree, key, key + 1));
+    }
+    for (NvU64 key = 0; key < 2048; key++) {
+        value = wide_radix_lookup(&dense_tree, key);
+        assert(value != NULL && *value == key + 1);
+    }
+    assert(wide_radix_lookup(&dense_tree, 2048) == NULL);
+    printf("   ✓ 2048 keys found after growing nodes to 256 children\n");
+    
+    for (NvU64 key = 0; key < 2048; key += 2) {
+        assert(wide_radix_delete(&dense_tree, key));
+    }
+    for (NvU64 key = 0; key < 2048; key++) {
+        value = wide_radix_lookup(&dense_tree, key);
+        assert((key & 1) ? (value != NULL && *value == key + 1) : (value == NULL));
+    }
+    printf("   ✓ Dense child arrays stay ordered after deletes\n");
+    
+    size_t num_nodes = 0;
+    size_t bytes = wide_radix_memory_usage(&dense_tree, &num_nodes);
+    assert(num_nodes > 0 && bytes > 0);
+    printf("   ✓ %zu live nodes, %zu bytes held\n", num_nodes, bytes);
+    wide_radix_destroy(&dense_tree);
+    
+    printf("5. Testing node pruning...\n");
+    
+    // Sparse keys each need their own path of nodes
+    wide_radix_tree_t churn_tree;
+    wide_radix_init(&churn_tree, 64);
+    NvU64 churn_keys[512];
+    for (int i = 0; i < 512; i++) {
+        churn_keys[i] = (NvU64)(i + 1) * 0x9E3779B97F4A7C15ULL;
+        assert(wide_radix_insert(&churn_tree, churn_keys[i], i));
+    }
+    size_t churn_bytes = wide_radix_memory_usage(&churn_tree, NULL);
+    
+    // Replacing keys many times over must not grow the tree
+    for (int round = 1; round <= 50; round++) {
+        for (int i = 0; i < 512; i++) {
+            assert(wide_radix_delete(&churn_tree, churn_keys[i]));
+            churn_keys[i] = (churn_keys[i] ^ ((NvU64)round << 40)) * 0xBF58476D1CE4E5B9ULL;
+            assert(wide_radix_insert(&churn_tree, churn_keys[i], i));
+        }
+    }
+    for (int i = 0; i < 512; i++) {
+        value = wide_radix_lookup(&churn_tree, churn_keys[i]);
+        assert(value != NULL && *value == (NvU64)i);
+    }
+    assert(wide_radix_memory_usage(&churn_tree, NULL) <= 2 * churn_bytes);
+    printf("   ✓ Memory stable under churn (%zu -> %zu bytes)\n", churn_bytes, wide_radix_memory_usage(&churn_tree, NULL));
+    
+    for (int i = 0; i < 512; i++) {
+        assert(wide_radix_delete(&churn_tree, churn_keys[i]));
+    }
+    wide_radix_memory_usage(&churn_tree, &num_nodes);
+    assert(wide_radix_empty(&churn_tree) && num_nodes == 1);
+    printf("   ✓ Deleting every key prunes the tree down to the root\n");
+    wide_radix_destroy(&churn_tree);
+    
+    printf("6. Testing find_geq...\n");
+    
+    // Keys share prefixes at different depths, so successors often sit
+    // several levels above the point where the search key diverges
+    wide_radix_tree_t geq_tree;
+    wide_radix_init(&geq_tree, 64);
+    NvU64 geq_keys[300];
+    int geq_present[300];
+    for (int i = 0; i < 300; i++) {
+        geq_keys[i] = ((NvU64)(i % 5) << 56) | ((NvU64)(i % 17) << 32) | ((NvU64)i * 0x10001);
+        geq_present[i] = 1;
+        assert(wide_radix_insert(&geq_tree, geq_keys[i], geq_keys[i]));
+    }
+    for (int q = 0; q < 2000; q++) {
+        NvU64 query = (q & 1) ? geq_keys[q % 300] + (NvU64)(q % 3) : (NvU64)q * 0x0123456789ABCDULL;
+        int best = testBruteForceGEQ(geq_keys, geq_present, 300, query);
+        NvU64 found_key = 0;
+        value = wide_radix_find_geq_key(&geq_tree, query, &found_key);
+        assert(best >= 0 ? (value != NULL && *value == geq_keys[best] && found_key == geq_keys[best]) : (value == NULL));
+    }
+    assert(wide_radix_find_geq(&geq_tree, 0xFFFFFFFFFFFFFFFFULL) == NULL);
+    printf("   ✓ Successor search backtracks across levels\n");
+    wide_radix_destroy(&geq_tree);
+    
+    printf("7. Testing narrow keys...\n");
+    
+    // 36-bit keys need 5 levels; the top level only uses its low 4 bits
+    wide_radix_tree_t narrow_tree;
+    wide_radix_init(&narrow_tree, 36);
+    assert(narrow_tree.num_levels == 5);
+    NvU64 narrow_max = (1ULL << 36) - 1;
+    for (NvU64 i = 0; i < 1000; i++) {
+        NvU64 key = (i * 0x9E3779B97ULL) & narrow_max;
+        assert(wide_radix_insert(&narrow_tree, key, key + 1));
+    }
+    for (NvU64 i = 0; i < 1000; i++) {
+        NvU64 key = (i * 0x9E3779B97ULL) & narrow_max;
+        value = wide_radix_lookup(&narrow_tree, key);
+        assert(value != NULL && *value == key + 1);
+    }
+    assert(wide_radix_insert(&narrow_tree, narrow_max, 7));
+    NvU64 found_key = 0;
+    value = wide_radix_find_geq_key(&narrow_tree, narrow_max - 1, &found_key);
+    assert(value != NULL && *value == 7 && found_key == narrow_max);
+    
+    // Keys wider than key_bits are rejected and never found
+    assert(!wide_radix_insert(&narrow_tree, 1ULL << 36, 1));
+    assert(wide_radix_lookup(&narrow_tree, (1ULL << 36) | 5) == NULL);
+    assert(wide_radix_find_geq(&narrow_tree, 1ULL << 36) == NULL);
+    assert(!wide_radix_delete(&narrow_tree, 1ULL << 36));
+    
+    size_t narrow_nodes = 0;
+    wide_radix_memory_usage(&narrow_tree, &narrow_nodes);
+    for (NvU64 i = 0; i < 1000; i++) {
+        assert(wide_radix_delete(&narrow_tree, (i * 0x9E3779B97ULL) & narrow_max));
+    }
+    assert(wide_radix_delete(&narrow_tree, narrow_max));
+    assert(wide_radix_empty(&narrow_tree));
+    wide_radix_destroy(&narrow_tree);
+    
+    // 16-bit keys: a two-level tree holding the whole key space
+    wide_radix_tree_t short_tree;
+    wide_radix_init(&short_tree, 16);
+    for (NvU64 key = 0; key < 65536; key += 3) {
+        assert(wide_radix_insert(&short_tree, key, key));
+    }
+    for (NvU64 key = 0; key < 65536; key++) {
+        value = wide_radix_find_geq_key(&short_tree, key, &found_key);
+        NvU64 expected = (key + 2) / 3 * 3;
+        assert(expected < 65536 ? (value != NULL && found_key == expected) : (value == NULL));
+    }
+    wide_radix_memory_usage(&short_tree, &narrow_nodes);
+    assert(narrow_nodes == 257);
+    wide_radix_destroy(&short_tree);
+    printf("   ✓ Level count follows key_bits\n");
+    
+    printf("8. Testing arena allocation...\n");
+    
+    wide_radix_tree_t arena_tree;
+    wide_radix_init_with_flags(&arena_tree, 64, WIDE_RADIX_FLAG_ARENA);
+    size_t first_round_bytes = 0;
+    for (int round = 0; round < 3; round++) {
+        // Enough sparse keys to spill into several chunks
+        for (NvU64 i = 0; i < 20000; i++) {
+            NvU64 key = i * 0x9E3779B97F4A7C15ULL;
+            assert(wide_radix_insert(&arena_tree, key, i));
+        }
+        for (NvU64 i = 0; i < 20000; i += 2) {
+            assert(wide_radix_delete(&arena_tree, i * 0x9E3779B97F4A7C15ULL));
+        }
+        for (NvU64 i = 0; i < 20000; i++) {
+            value = wide_radix_lookup(&arena_tree, i * 0x9E3779B97F4A7C15ULL);
+            assert((i & 1) ? (value != NULL && *value == i) : (value == NULL));
+        }
+        
+        // Resetting reuses the chunks instead of allocating new ones
+        size_t bytes = wide_radix_memory_usage(&arena_tree, NULL);
+        assert(bytes > WIDE_RADIX_ARENA_CHUNK_SIZE);
+        if (round == 0) {
+            first_round_bytes = bytes;
+        } else {
+            assert(bytes == first_round_bytes);
+        }
+        wide_radix_reset(&arena_tree);
+        assert(wide_radix_empty(&arena_tree));
+        assert(wide_radix_lookup(&arena_tree, 0x9E3779B97F4A7C15ULL) == NULL);
+    }
+    wide_radix_destroy(&arena_tree);
+    assert(wide_radix_memory_usage(&arena_tree, NULL) == 0);
+    
+    // Reset also works for malloc-backed trees
+    wide_radix_tree_t plain_tree;
+    wide_radix_init(&plain_tree, 32);
+    assert(wide_radix_insert(&plain_tree, 12345, 1));
+    wide_radix_reset(&plain_tree);
+    assert(wide_radix_empty(&plain_tree) && plain_tree.key_bits == 32);
+    assert(wide_radix_insert(&plain_tree, 12345, 2));
+    assert(*wide_radix_lookup(&plain_tree, 12345) == 2);
+    wide_radix_destroy(&plain_tree);
+    printf("   ✓ Arena trees reuse their chunks across resets\n");
+    
     printf("\nAll tests passed! ✓\n");
     return 0;
 }
@@ -0,0 +1,237 @@
+#include "va_allocator.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Mock CU_ASSERT for testing
+#define CU_ASSERT(expr) do { if (!(expr)) { printf("Assertion failed: %s\n", #expr); exit(1); } } while(0)
+
+static inline CUvaFreeRange *
+vaRangeFromSizeNode(CUradixNode *node)
+{
+    return (CUvaFreeRange *)((char *)node - offsetof(CUvaFreeRange, size_node));
+}
+
+static inline CUvaFreeRange *
+vaRangeFromAddrNode(CUradixNode *node)
+{
+    return (CUvaFreeRange *)((char *)node - offsetof(CUvaFreeRange, addr_node));
+}
+
+static inline NvU64
+vaRangeStart(CUvaFreeRange *range)
+{
+    return range->addr_node.key;
+}
+
+static inline NvU64
+vaRangeLength(CUvaFreeRange *range)
+{
+    return range->size_node.key;
+}
+
+// Inclusive: a range can end at the top of the address space, where the
+// exclusive end would wrap to 0
+static inline NvU64
+vaRangeLast(CUvaFreeRange *range)
+{
+    return vaRangeStart(range) + vaRangeLength(range) - 1;
+}
+
+static void
+vaRangeLink(CUvaAllocator *va, CUvaFreeRange *range, NvU64 start, NvU64 length)
+{
+    CU_ASSERT(length > 0);
+
+    radixTreeInsert(&va->by_size, &range->size_node, length);
+    radixTreeInsert(&va->by_addr, &range->addr_node, start);
+}
+
+static void
+vaRangeUnlink(CUvaFreeRange *range)
+{
+    radixTreeRemove(&range->size_node);
+    radixTreeRemove(&range->addr_node);
+}
+
+// A range whose start stays put only needs its size index updated
+static void
+vaRangeResize(CUvaAllocator *va, CUvaFreeRange *range, NvU64 length)
+{
+    radixTreeRemove(&range->size_node);
+    radixTreeInsert(&va->by_size, &range->size_node, length);
+}
+
+int
+vaAllocatorInit(CUvaAllocator *va, NvU64 base, NvU64 size)
+{
+    CU_ASSERT(va);
+    CU_ASSERT(size == 0 || base + size - 1 >= base);
+
+    memset(va, 0, sizeof(*va));
+    radixTreeInit(&va->by_size, 64);
+    radixTreeInit(&va->by_addr, 64);
+    va->base = base;
+    va->size = size;
+
+    if (size > 0) {
+        CUvaFreeRange *range = (CUvaFreeRange *)malloc(sizeof(*range));
+        if (!range) {
+            return -1;
+        }
+        vaRangeLink(va, range, base, size);
+        va->free_bytes = size;
+        va->num_free_ranges = 1;
+    }
+    return 0;
+}
+
+void
+vaAllocatorDestroy(CUvaAllocator *va)
+{
+    CUradixNode *node;
+
+    CU_ASSERT(va);
+
+    // Unlink before freeing: iterating would follow parent links into
+    // ranges that were already freed
+    while ((node = radixTreeFindGEQ(&va->by_addr, 0)) != NULL) {
+        CUvaFreeRange *range = vaRangeFromAddrNode(node);
+        vaRangeUnlink(range);
+        free(range);
+    }
+    memset(va, 0, sizeof(*va));
+}
+
+int
+vaAllocatorAlloc(CUvaAllocator *va, NvU64 size, NvU64 alignment, NvU64 *addr)
+{
+    CUradixNode *node;
+    CUvaFreeRange *range = NULL;
+    NvU64 start = 0;
+    NvU64 aligned = 0;
+    NvU64 head;
+    NvU64 tail;
+
+    CU_ASSERT(va);
+    CU_ASSERT(addr);
+    CU_ASSERT(size > 0);
+    CU_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    // Ranges in increasing size; alignment padding can make a range too
+    // small, but any range of at least size + alignment - 1 bytes fits, so
+    // the scan stops there at the latest
+    for (node = radixTreeFindGEQ(&va->by_size, size); node; node = radixTreeNext(node)) {
+        range = vaRangeFromSizeNode(node);
+        start = vaRangeStart(range);
+        aligned = (start + alignment - 1) & ~(alignment - 1);
+        if (aligned >= start && aligned - start <= vaRangeLength(range) - size) {
+            break;
+        }
+    }
+    if (node == NULL) {
+        return -1;
+    }
+
+    head = aligned - start;
+    tail = vaRangeLast(range) - (aligned + size - 1);
+
+    if (head > 0 && tail > 0) {
+        CUvaFreeRange *tail_range = (CUvaFreeRange *)malloc(sizeof(*tail_range));
+        if (!tail_range) {
+            return -1;
+        }
+        vaRangeResize(va, range, head);
+        vaRangeLink(va, tail_range, aligned + size, tail);
+        va->num_free_ranges++;
+    }
+    else if (head > 0) {
+        vaRangeResize(va, range, head);
+    }
+    else if (tail > 0) {
+        vaRangeUnlink(range);
+        vaRangeLink(va, range, aligned + size, tail);
+    }
+    else {
+        vaRangeUnlink(range);
+        free(range);
+        va->num_free_ranges--;
+    }
+
+    va->free_bytes -= size;
+    *addr = aligned;
+    return 0;
+}
+
+int
+vaAllocatorFree(CUvaAllocator *va, NvU64 addr, NvU64 size)
+{
+    CUradixNode *prev_node;
+    CUradixNode *next_node;
+    CUvaFreeRange *prev = NULL;
+    CUvaFreeRange *next = NULL;
+    NvU64 last = addr + size - 1;
+
+    CU_ASSERT(va);
+    CU_ASSERT(size > 0);
+    CU_ASSERT(addr >= va->base && last >= addr && last - va->base < va->size);
+
+    // The free ranges on either side; neither may overlap the freed range
+    prev_node = radixTreeFindLEQ(&va->by_addr, addr);
+    if (prev_node) {
+        prev = vaRangeFromAddrNode(prev_node);
+        CU_ASSERT(vaRangeLast(prev) < addr);
+    }
+    next_node = radixTreeFindGEQ(&va->by_addr, addr);
+    if (next_node) {
+        next = vaRangeFromAddrNode(next_node);
+        CU_ASSERT(vaRangeStart(next) > last);
+    }
+
+    // Neither side can wrap: prev ends below addr and next starts above last
+    if (prev && vaRangeLast(prev) + 1 != addr) {
+        prev = NULL;
+    }
+    if (next && vaRangeStart(next) - 1 != last) {
+        next = NULL;
+    }
+
+    if (prev && next) {
+        NvU64 length = vaRangeLength(prev) + size + vaRangeLength(next);
+        vaRangeUnlink(next);
+        free(next);
+        vaRangeResize(va, prev, length);
+        va->num_free_ranges--;
+    }
+    else if (prev) {
+        vaRangeResize(va, prev, vaRangeLength(prev) + size);
+    }
+    else if (next) {
+        NvU64 length = size + vaRangeLength(next);
+        vaRangeUnlink(next);
+        vaRangeLink(va, next, addr, length);
+    }
+    else {
+        CUvaFreeRange *range = (CUvaFreeRange *)malloc(sizeof(*range));
+        if (!range) {
+            return -1;
+        }
+        vaRangeLink(va, range, addr, size);
+        va->num_free_ranges++;
+    }
+
+    va->free_bytes += size;
+    return 0;
+}
+
+NvU64
+vaAllocatorLargestFree(CUvaAllocator *va)
+{
+    CUradixNode *node;
+
+    CU_ASSERT(va);
+
+    node = radixTreeFindLEQ(&va->by_size, ~0ULL);
+    return node ? node->key : 0;
+}
@@ -0,0 +1,62 @@
+#ifndef __VA_ALLOCATOR_H__
+#define __VA_ALLOCATOR_H__
+
+#include "radix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reference virtual-address range allocator on two CUradixTree indexes.
+// Every free range sits in a tree keyed by its length, for best-fit
+// allocation, and in a tree keyed by its start address, for coalescing a
+// freed range with its neighbours. Allocated ranges aren't tracked: free
+// takes the address and size that alloc handed out.
+typedef struct CUvaFreeRange_st CUvaFreeRange;
+typedef struct CUvaAllocator_st CUvaAllocator;
+
+struct CUvaFreeRange_st
+{
+    CUradixNode size_node;  // Key: length
+    CUradixNode addr_node;  // Key: start address
+};
+
+struct CUvaAllocator_st
+{
+    CUradixTree by_size;
+    CUradixTree by_addr;
+    NvU64 base;
+    NvU64 size;
+    NvU64 free_bytes;
+    NvU64 num_free_ranges;
+};
+
+// Manages [base, base + size), which may end at the top of the address
+// space. Returns 0 on success, -1 if out of memory.
+CUDA_TEST_EXPORT int
+vaAllocatorInit(CUvaAllocator *va, NvU64 base, NvU64 size);
+
+CUDA_TEST_EXPORT void
+vaAllocatorDestroy(CUvaAllocator *va);
+
+// Best fit: takes the smallest free range that can hold size bytes at the
+// given alignment (a power of two), carving the allocation from the lowest
+// aligned address in it. Returns 0 and the address in *addr, or -1 if no
+// free range fits or splitting the range ran out of memory.
+CUDA_TEST_EXPORT int
+vaAllocatorAlloc(CUvaAllocator *va, NvU64 size, NvU64 alignment, NvU64 *addr);
+
+// Returns [addr, addr + size) to the free ranges, merging it with free
+// neighbours. Returns 0, or -1 if a new free range couldn't be allocated.
+CUDA_TEST_EXPORT int
+vaAllocatorFree(CUvaAllocator *va, NvU64 addr, NvU64 size);
+
+// Length of the largest free range, 0 if none
+CUDA_TEST_EXPORT NvU64
+vaAllocatorLargestFree(CUvaAllocator *va);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,86 +1,242 @@
 #include "wide_radix.h"
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
 
-// Extract 8-bit byte from 64-bit key at given level (0-7)
-static inline uint8_t extract_byte(NvU64 key, int level) {
-    return (key >> ((7 - level) * 8)) & 0xFF;
+// Index of the last level, whose nodes hold the values inline
+static inline int last_level(const wide_radix_tree_t* tree) {
+    return (int)tree->num_levels - 1;
 }
 
-// Create a new node
-static wide_radix_node_t* create_node(bool is_leaf) {
-    wide_radix_node_t* node = (wide_radix_node_t*)calloc(1, sizeof(wide_radix_node_t));
+// Extract the key byte consumed at the given level; level 0 holds the most
+// significant byte of a key_bits wide key
+static inline uint8_t extract_byte(const wide_radix_tree_t* tree, NvU64 key, int level) {
+    return (key >> ((last_level(tree) - level) * 8)) & 0xFF;
+}
+
+// Keys with bits set above key_bits cannot be stored
+static inline bool key_in_range(const wide_radix_tree_t* tree, NvU64 key) {
+    return tree->key_bits >= 64 || (key >> tree->key_bits) == 0;
+}
+
+// Free nodes are chained through their first bytes
+typedef struct wide_radix_free_st {
+    struct wide_radix_free_st* next;
+} wide_radix_free_t;
+
+// Both node types are resized and recycled through the same code
+_Static_assert(offsetof(wide_radix_node_t, children) == offsetof(wide_radix_leaf_node_t, values) &&
+               sizeof(wide_radix_node_t*) == sizeof(NvU64), "node types must share their layout");
+
+static inline unsigned class_capacity(int size_class) {
+    return size_class == 0 ? 0 : 1u << (size_class - 1);
+}
+
+static inline size_t class_size(int size_class) {
+    return sizeof(wide_radix_node_t) + class_capacity(size_class) * sizeof(wide_radix_node_t*);
+}
+
+// Smallest size class holding num_slots slots
+static inline int size_class_for(unsigned num_slots) {
+    if (num_slots <= 1) {
+        return (int)num_slots;
+    }
+    return 33 - __builtin_clz(num_slots - 1);
+}
+
+static inline int node_size_class(const wide_radix_node_t* node) {
+    return size_class_for(node->capacity);
+}
+
+// Carve size bytes from the arena, moving on to the next chunk (reused after
+// a reset, or newly allocated) when the current one is exhausted
+static void* arena_alloc(wide_radix_tree_t* tree, size_t size) {
+    if (tree->arena_next == NULL || (size_t)(tree->arena_end - tree->arena_next) < size) {
+        wide_radix_chunk_t* chunk = tree->arena_current ? tree->arena_current->next : tree->arena_chunks;
+        if (!chunk) {
+            chunk = (wide_radix_chunk_t*)malloc(sizeof(wide_radix_chunk_t) + WIDE_RADIX_ARENA_CHUNK_SIZE);
+            if (!chunk) return NULL;
+            chunk->next = NULL;
+            chunk->size = WIDE_RADIX_ARENA_CHUNK_SIZE;
+            if (tree->arena_current) {
+                tree->arena_current->next = chunk;
+            } else {
+                tree->arena_chunks = chunk;
+            }
+            tree->bytes_allocated += sizeof(wide_radix_chunk_t) + chunk->size;
+        }
+        tree->arena_current = chunk;
+        tree->arena_next = (char*)(chunk + 1);
+        tree->arena_end = tree->arena_next + chunk->size;
+    }
+    void* result = tree->arena_next;
+    tree->arena_next += size;
+    return result;
+}
+
+// Get a node of the given size class, reusing a recycled one when available
+static wide_radix_node_t* alloc_node(wide_radix_tree_t* tree, int size_class) {
+    wide_radix_node_t* node = (wide_radix_node_t*)tree->free_lists[size_class];
     if (node) {
-        node->is_leaf = is_leaf;
-        node->value = 0;
-        // child_mask is already zeroed by calloc
-        // children array is already NULLed by calloc
+        tree->free_lists[size_class] = ((wide_radix_free_t*)node)->next;
+    } else if (tree->flags & WIDE_RADIX_FLAG_ARENA) {
+        node = (wide_radix_node_t*)arena_alloc(tree, class_size(size_class));
+        if (!node) return NULL;
+    } else {
+        node = (wide_radix_node_t*)malloc(class_size(size_class));
+        if (!node) return NULL;
+        tree->bytes_allocated += class_size(size_class);
     }
+    memset(node, 0, sizeof(wide_radix_node_t));
+    node->capacity = (uint16_t)class_capacity(size_class);
     return node;
 }
 
+static void release_node(wide_radix_tree_t* tree, wide_radix_node_t* node) {
+    int size_class = node_size_class(node);
+    ((wide_radix_free_t*)node)->next = (wide_radix_free_t*)tree->free_lists[size_class];
+    tree->free_lists[size_class] = node;
+}
+
+// Child for a byte whose mask bit is known to be set
+static inline wide_radix_node_t* get_child(const wide_radix_node_t* node, int byte) {
+    return node->children[mask_rank(&node->child_mask, byte)];
+}
+
+// Make room for byte in the dense slots of *link (either node type), moving
+// the node to the next size class if it is full. The caller fills the
+// returned slot. Returns -1 on allocation failure.
+static int insert_slot(wide_radix_tree_t* tree, wide_radix_node_t** link, int byte) {
+    wide_radix_node_t* node = *link;
+    int count = mask_count(&node->child_mask);
+    int rank = mask_rank(&node->child_mask, byte);
+    
+    if (count == node->capacity) {
+        wide_radix_node_t* grown = alloc_node(tree, node_size_class(node) + 1);
+        if (!grown) return -1;
+        uint16_t capacity = grown->capacity;
+        memcpy(grown, node, sizeof(wide_radix_node_t) + count * sizeof(wide_radix_node_t*));
+        grown->capacity = capacity;
+        release_node(tree, node);
+        node = grown;
+        *link = node;
+    }
+    
+    memmove(&node->children[rank + 1], &node->children[rank], (count - rank) * sizeof(wide_radix_node_t*));
+    mask_set_bit(&node->child_mask, byte);
+    return rank;
+}
+
+static void remove_slot(wide_radix_node_t* node, int byte) {
+    int count = mask_count(&node->child_mask);
+    int rank = mask_rank(&node->child_mask, byte);
+    memmove(&node->children[rank], &node->children[rank + 1], (count - rank - 1) * sizeof(wide_radix_node_t*));
+    mask_clear_bit(&node->child_mask, byte);
+}
+
+// Move *link to a smaller size class once it is at most a quarter full,
+// leaving room for twice its children so insert/delete churn doesn't thrash
+static void shrink_node(wide_radix_tree_t* tree, wide_radix_node_t** link) {
+    wide_radix_node_t* node = *link;
+    unsigned count = (unsigned)mask_count(&node->child_mask);
+    
+    if (node->capacity <= 2 || count * 4 > node->capacity) {
+        return;
+    }
+    wide_radix_node_t* shrunk = alloc_node(tree, size_class_for(count * 2));
+    if (!shrunk) return;  // Keep the larger node
+    uint16_t capacity = shrunk->capacity;
+    memcpy(shrunk, node, sizeof(wide_radix_node_t) + count * sizeof(wide_radix_node_t*));
+    shrunk->capacity = capacity;
+    release_node(tree, node);
+    *link = shrunk;
+}
+
 // Free a node and all its children recursively
-static void free_node(wide_radix_node_t* node) {
+static void free_node(wide_radix_node_t* node, int level, int last) {
     if (!node) return;
     
-    if (!node->is_leaf) {
-        for (int i = 0; i < 256; i++) {
-            if (mask_get_bit(&node->child_mask, i) && node->children[i]) {
-                free_node(node->children[i]);
-            }
+    if (level < last) {
+        int count = mask_count(&node->child_mask);
+        for (int i = 0; i < count; i++) {
+            free_node(node->children[i], level + 1, last);
         }
     }
     free(node);
 }
 
+static size_t count_nodes(const wide_radix_node_t* node, int level, int last) {
+    size_t count = 1;
+    if (level < last) {
+        int num_children = mask_count(&node->child_mask);
+        for (int i = 0; i < num_children; i++) {
+            count += count_nodes(node->children[i], level + 1, last);
+        }
+    }
+    return count;
+}
+
 void wide_radix_init(wide_radix_tree_t* tree, NvU32 key_bits) {
+    wide_radix_init_with_flags(tree, key_bits, 0);
+}
+
+void wide_radix_init_with_flags(wide_radix_tree_t* tree, NvU32 key_bits, NvU32 flags) {
     assert(tree != NULL);
-    tree->root = create_node(false);  // Create internal root node
+    assert(key_bits >= 1 && key_bits <= 64);
+    memset(tree, 0, sizeof(*tree));
     tree->key_bits = key_bits;
+    tree->num_levels = (key_bits + 7) / 8;
+    tree->flags = flags;
+    tree->root = alloc_node(tree, 0);  // Create internal root node, grown on first insert
 }
 
 bool wide_radix_insert(wide_radix_tree_t* tree, NvU64 key, NvU64 value) {
     assert(tree != NULL && tree->root != NULL);
     
-    wide_radix_node_t* current = tree->root;
+    if (!key_in_range(tree, key)) return false;
+    
+    wide_radix_node_t** link = &tree->root;
+    int last = last_level(tree);
     
-    // Navigate through the tree levels (0-7 for 64-bit keys)
-    for (int level = 0; level < 7; level++) {
-        uint8_t byte = extract_byte(key, level);
+    // Navigate through the internal levels (0-6 for 64-bit keys)
+    for (int level = 0; level < last; level++) {
+        wide_radix_node_t* current = *link;
+        uint8_t byte = extract_byte(tree, key, level);
+        int rank;
         
         if (mask_get_bit(&current->child_mask, byte)) {
-            // Child exists, continue to next level
-            current = current->children[byte];
-            assert(current != NULL);
+            rank = mask_rank(&current->child_mask, byte);
         } else {
-            // Child doesn't exist, create internal node
-            wide_radix_node_t* new_node = create_node(false);
+            // Child doesn't exist, create a node with room for one slot
+            wide_radix_node_t* new_node = alloc_node(tree, 1);
             if (!new_node) return false;
             
-            mask_set_bit(&current->child_mask, byte);
-            current->children[byte] = new_node;
-            current = new_node;
+            rank = insert_slot(tree, link, byte);
+            if (rank < 0) {
+                release_node(tree, new_node);
+                return false;
+            }
+            current = *link;
+            current->children[rank] = new_node;
         }
+        
+        // Continue to next level
+        link = &current->children[rank];
     }
     
-    // At the final level (level 7), create or update leaf
-    uint8_t final_byte = extract_byte(key, 7);
+    // At the final level (level 7 for 64-bit keys), store the value inline
+    wide_radix_leaf_node_t* leaf = (wide_radix_leaf_node_t*)*link;
+    uint8_t final_byte = extract_byte(tree, key, last);
     
-    if (mask_get_bit(&current->child_mask, final_byte)) {
-        // Leaf already exists, update value
-        wide_radix_node_t* leaf = current->children[final_byte];
-        assert(leaf->is_leaf);
-        leaf->value = value;
+    if (mask_get_bit(&leaf->child_mask, final_byte)) {
+        // Key already exists, update value
+        leaf->values[mask_rank(&leaf->child_mask, final_byte)] = value;
     } else {
-        // Create new leaf
-        wide_radix_node_t* leaf = create_node(true);
-        if (!leaf) return false;
-        
-        leaf->value = value;
-        mask_set_bit(&current->child_mask, final_byte);
-        current->children[final_byte] = leaf;
+        int rank = insert_slot(tree, link, final_byte);
+        if (rank < 0) return false;
+        ((wide_radix_leaf_node_t*)*link)->values[rank] = value;
     }
     
     return true;
@@ -89,40 +245,44 @@ bool wide_radix_insert(wide_radix_tree_t* tree, NvU64 key, NvU64 value) {
 bool wide_radix_delete(wide_radix_tree_t* tree, NvU64 key) {
     assert(tree != NULL && tree->root != NULL);
     
-    wide_radix_node_t* current = tree->root;
-    wide_radix_node_t* parent = NULL;
-    uint8_t parent_byte = 0;
+    if (!key_in_range(tree, key)) return false;
+    
+    // links[level] is the slot pointing at the node of that level
+    wide_radix_node_t** links[WIDE_RADIX_MAX_LEVELS];
+    uint8_t bytes[WIDE_RADIX_MAX_LEVELS];
+    int last = last_level(tree);
     
-    // Navigate to the leaf
-    for (int level = 0; level < 7; level++) {
-        uint8_t byte = extract_byte(key, level);
+    // Navigate to the last-level node, remembering the path
+    links[0] = &tree->root;
+    for (int level = 0; level < last; level++) {
+        wide_radix_node_t* current = *links[level];
+        bytes[level] = extract_byte(tree, key, level);
         
-        if (!mask_get_bit(&current->child_mask, byte)) {
+        if (!mask_get_bit(&current->child_mask, bytes[level])) {
             return false;  // Key doesn't exist
         }
         
-        parent = current;
-        parent_byte = byte;
-        current = current->children[byte];
-        assert(current != NULL);
+        links[level + 1] = &current->children[mask_rank(&current->child_mask, bytes[level])];
     }
     
     // Check final level
-    uint8_t final_byte = extract_byte(key, 7);
-    if (!mask_get_bit(&current->child_mask, final_byte)) {
+    bytes[last] = extract_byte(tree, key, last);
+    if (!mask_get_bit(&(*links[last])->child_mask, bytes[last])) {
         return false;  // Key doesn't exist
     }
     
-    wide_radix_node_t* leaf = current->children[final_byte];
-    assert(leaf->is_leaf);
-    
-    // Remove the leaf
-    free(leaf);
-    current->children[final_byte] = NULL;
-    mask_clear_bit(&current->child_mask, final_byte);
-    
-    // Clean up empty internal nodes (optional optimization)
-    // For now, we'll leave empty internal nodes to avoid complexity
+    // Remove the value, then unwind: nodes left empty are recycled and
+    // removed from their parent; the first non-empty one may shrink. The
+    // root is kept even when empty.
+    for (int level = last; level >= 0; level--) {
+        wide_radix_node_t* node = *links[level];
+        remove_slot(node, bytes[level]);
+        if (level == 0 || mask_count(&node->child_mask) > 0) {
+            shrink_node(tree, links[level]);
+            break;
+        }
+        release_node(tree, node);
+    }
     
     return true;
 }
@@ -130,86 +290,91 @@ bool wide_radix_delete(wide_radix_tree_t* tree, NvU64 key) {
 NvU64* wide_radix_lookup(wide_radix_tree_t* tree, NvU64 key) {
     assert(tree != NULL && tree->root != NULL);
     
+    if (!key_in_range(tree, key)) return NULL;
+    
     wide_radix_node_t* current = tree->root;
+    int last = last_level(tree);
     
-    // Navigate through all levels
-    for (int level = 0; level < 8; level++) {
-        uint8_t byte = extract_byte(key, level);
+    // Navigate through the internal levels
+    for (int level = 0; level < last; level++) {
+        uint8_t byte = extract_byte(tree, key, level);
         if (!mask_get_bit(&current->child_mask, byte)) {
             return NULL;  // Key doesn't exist
         }
         
-        current = current->children[byte];
+        current = get_child(current, byte);
         assert(current != NULL);
-        
-        if (level == 7) {
-            // We've reached the leaf level
-            assert(current->is_leaf);
-            return &current->value;
-        }
     }
     
-    return NULL;  // Should never reach here
+    // We've reached the last level, the value is stored inline
+    wide_radix_leaf_node_t* leaf = (wide_radix_leaf_node_t*)current;
+    uint8_t final_byte = extract_byte(tree, key, last);
+    if (!mask_get_bit(&leaf->child_mask, final_byte)) {
+        return NULL;
+    }
+    return &leaf->values[mask_rank(&leaf->child_mask, final_byte)];
 }
 
 NvU64* wide_radix_find_geq(wide_radix_tree_t* tree, NvU64 key) {
+    return wide_radix_find_geq_key(tree, key, NULL);
+}
+
+NvU64* wide_radix_find_geq_key(wide_radix_tree_t* tree, NvU64 key, NvU64* found_key) {
     assert(tree != NULL && tree->root != NULL);
     
-    // For simplicity, we'll implement a basic version that finds the next key
-    // A full implementation would need to traverse the tree more carefully
+    // Every stored key is below 2^key_bits, so nothing is >= a larger key
+    if (!key_in_range(tree, key)) return NULL;
     
-    wide_radix_node_t* current = tree->root;
-    NvU64 current_key = 0;
+    wide_radix_node_t* path[WIDE_RADIX_MAX_LEVELS];
+    int last = last_level(tree);
+    int level;
+    int next;
     
-    // Navigate through levels, building the key as we go
-    for (int level = 0; level < 8; level++) {
-        uint8_t byte = extract_byte(key, level);
-        
-        if (mask_get_bit(&current->child_mask, byte)) {
-            // Exact match at this level, continue
-            current = current->children[byte];
-            assert(current != NULL);
-            current_key |= ((NvU64)byte << ((7 - level) * 8));
-        } else {
-            // Find the next available child at this level
-            for (int next_byte = byte + 1; next_byte < 256; next_byte++) {
-                if (mask_get_bit(&current->child_mask, next_byte)) {
-                    // Found a larger key, navigate to it
-                    current = current->children[next_byte];
-                    assert(current != NULL);
-                    current_key |= ((NvU64)next_byte << ((7 - level) * 8));
-                    
-                    // Navigate to the leftmost leaf in this subtree
-                    for (int remaining_level = level + 1; remaining_level < 8; remaining_level++) {
-                        // Find the smallest child
-                        for (int child_byte = 0; child_byte < 256; child_byte++) {
-                            if (mask_get_bit(&current->child_mask, child_byte)) {
-                                current = current->children[child_byte];
-                                assert(current != NULL);
-                                current_key |= ((NvU64)child_byte << ((7 - remaining_level) * 8));
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if (current->is_leaf) {
-                        return &current->value;
-                    }
-                    return NULL;
-                }
-            }
-            // No larger key found at this level
-            return NULL;
+    // Follow the key as far as it exists in the tree
+    path[0] = tree->root;
+    for (level = 0; level < last; level++) {
+        uint8_t byte = extract_byte(tree, key, level);
+        if (!mask_get_bit(&path[level]->child_mask, byte)) {
+            break;
         }
-        
-        if (level == 7) {
-            // We've reached the leaf level
-            assert(current->is_leaf);
-            return &current->value;
+        path[level + 1] = get_child(path[level], byte);
+    }
+    
+    // At the last level the key itself qualifies; above it only larger bytes do
+    if (level == last) {
+        next = mask_next_bit(&path[level]->child_mask, extract_byte(tree, key, level));
+    } else {
+        next = mask_next_bit(&path[level]->child_mask, extract_byte(tree, key, level) + 1);
+    }
+    
+    // Backtrack until some level has a larger sibling
+    while (next > 255) {
+        if (level == 0) {
+            return NULL;
         }
+        level--;
+        next = mask_next_bit(&path[level]->child_mask, extract_byte(tree, key, level) + 1);
+    }
+    
+    // Build the result key: the prefix above level comes from the search key
+    int low_bits = (last - level + 1) * 8;
+    NvU64 result = low_bits >= 64 ? 0 : key & ~((1ULL << low_bits) - 1);
+    
+    // Descend along the smallest children; deletes prune empty nodes, so
+    // every internal node below the root has at least one child
+    for (; level < last; level++) {
+        result |= (NvU64)next << ((last - level) * 8);
+        path[level + 1] = get_child(path[level], next);
+        next = mask_next_bit(&path[level + 1]->child_mask, 0);
+        assert(next < 256);
     }
+    result |= (NvU64)next;
     
-    return NULL;
+    if (found_key) {
+        *found_key = result;
+    }
+    wide_radix_leaf_node_t* leaf = (wide_radix_leaf_node_t*)path[last];
+    return &leaf->values[mask_rank(&leaf->child_mask, next)];
 }
 
 bool wide_radix_empty(wide_radix_tree_t* tree) {
@@ -217,18 +382,63 @@ bool wide_radix_empty(wide_radix_tree_t* tree) {
     if (!tree->root) return true;
     
     // Check if root has any children
-    for (int i = 0; i < 256; i++) {
-        if (mask_get_bit(&tree->root->child_mask, i)) {
-            return false;
-        }
-    }
-    return true;
+    return mask_count(&tree->root->child_mask) == 0;
 }
 
 void wide_radix_destroy(wide_radix_tree_t* tree) {
     assert(tree != NULL);
+    if (tree->flags & WIDE_RADIX_FLAG_ARENA) {
+        // Every node, live or recycled, lives in a chunk
+        wide_radix_chunk_t* chunk = tree->arena_chunks;
+        while (chunk) {
+            wide_radix_chunk_t* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+        memset(tree->free_lists, 0, sizeof(tree->free_lists));
+        tree->arena_chunks = tree->arena_current = NULL;
+        tree->arena_next = tree->arena_end = NULL;
+        tree->root = NULL;
+        tree->bytes_allocated = 0;
+        return;
+    }
     if (tree->root) {
-        free_node(tree->root);
+        free_node(tree->root, 0, last_level(tree));
         tree->root = NULL;
     }
+    for (int i = 0; i < WIDE_RADIX_NUM_SIZE_CLASSES; i++) {
+        wide_radix_free_t* node = (wide_radix_free_t*)tree->free_lists[i];
+        while (node) {
+            wide_radix_free_t* next = node->next;
+            free(node);
+            node = next;
+        }
+        tree->free_lists[i] = NULL;
+    }
+    tree->bytes_allocated = 0;
+}
+
+void wide_radix_reset(wide_radix_tree_t* tree) {
+    assert(tree != NULL);
+    if (!(tree->flags & WIDE_RADIX_FLAG_ARENA)) {
+        NvU32 key_bits = tree->key_bits;
+        NvU32 flags = tree->flags;
+        wide_radix_destroy(tree);
+        wide_radix_init_with_flags(tree, key_bits, flags);
+        return;
+    }
+    
+    // Forget every node and carve the existing chunks again from the first
+    memset(tree->free_lists, 0, sizeof(tree->free_lists));
+    tree->arena_current = NULL;
+    tree->arena_next = tree->arena_end = NULL;
+    tree->root = alloc_node(tree, 0);
+}
+
+size_t wide_radix_memory_usage(wide_radix_tree_t* tree, size_t* num_nodes) {
+    assert(tree != NULL);
+    if (num_nodes) {
+        *num_nodes = tree->root ? count_nodes(tree->root, 0, last_level(tree)) : 0;
+    }
+    return tree->bytes_allocated;
 }
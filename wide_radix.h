@@ -2,6 +2,7 @@
 #define __WIDE_RADIX_H__
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include "utils_types.h"
 
@@ -17,28 +18,81 @@ typedef struct {
     uint64_t bits[4];  // 4 * 64 = 256 bits
 } wide_radix_mask_t;
 
-// Wide radix tree node (256 children)
+// Levels needed for 64-bit keys; narrower keys use ceil(key_bits / 8)
+#define WIDE_RADIX_MAX_LEVELS 8
+
+// Init flags
+#define WIDE_RADIX_FLAG_ARENA 0x1           // Carve nodes from large chunks, freed in bulk
+
+// Bytes per arena chunk; every node size class fits many times
+#define WIDE_RADIX_ARENA_CHUNK_SIZE (1 << 20)
+
+// Node size classes: capacity 0 (empty root), then 1, 2, 4, ..., 256 slots
+#define WIDE_RADIX_NUM_SIZE_CLASSES 10
+
+// Wide radix tree internal node (up to 256 children), every level but the last
+//
+// Only present children are stored, in a dense array ordered by key byte.
+// The slot of child byte b is the number of mask bits set below b (HAMT
+// style). Nodes come in power-of-two capacities and are reallocated into the
+// next size class when an insert finds them full.
 typedef struct wide_radix_node_st {
     wide_radix_mask_t child_mask;           // 256-bit mask indicating which children exist
-    struct wide_radix_node_st* children[256]; // 256 child pointers
-    NvU64 value;                            // Value stored at leaf nodes (0 for internal nodes)
-    bool is_leaf;                           // True if this is a leaf node
+    uint16_t capacity;                      // Number of slots allocated in children[]
+    struct wide_radix_node_st* children[];  // Present children, densely packed
 } wide_radix_node_t;
 
+// Last-level node (level num_levels - 1): same header, but the slots hold the values of
+// the keys themselves, so a key costs one 8-byte slot instead of a node.
+// Both node types share the size classes and free lists.
+typedef struct wide_radix_leaf_node_st {
+    wide_radix_mask_t child_mask;           // 256-bit mask indicating which keys exist
+    uint16_t capacity;                      // Number of slots allocated in values[]
+    NvU64 values[];                         // Values of present keys, densely packed
+} wide_radix_leaf_node_t;
+
+// Arena chunk header, followed by the node storage
+typedef struct wide_radix_chunk_st {
+    struct wide_radix_chunk_st* next;
+    size_t size;                            // Bytes of node storage after the header
+} wide_radix_chunk_t;
+
 // Wide radix tree structure
 typedef struct wide_radix_tree_st {
     wide_radix_node_t* root;
     NvU32 key_bits;                         // Number of bits in key (64 for NvU64)
+    NvU32 num_levels;                       // Levels walked per key, ceil(key_bits / 8)
+    void* free_lists[WIDE_RADIX_NUM_SIZE_CLASSES];  // Recycled nodes per size class
+    size_t bytes_allocated;                 // Bytes obtained from malloc, including free lists
+    NvU32 flags;                            // WIDE_RADIX_FLAG_*
+    wide_radix_chunk_t* arena_chunks;       // All chunks, in the order they are carved
+    wide_radix_chunk_t* arena_current;      // Chunk being carved
+    char* arena_next;                       // Next free byte in arena_current
+    char* arena_end;                        // End of arena_current's storage
 } wide_radix_tree_t;
 
 // Function declarations
+// Keys must fit in key_bits bits; wider keys are rejected by insert and
+// never found. Narrow keys skip the always-zero top levels entirely.
 WIDE_RADIX_EXPORT void wide_radix_init(wide_radix_tree_t* tree, NvU32 key_bits);
+// With WIDE_RADIX_FLAG_ARENA, nodes are carved from WIDE_RADIX_ARENA_CHUNK_SIZE
+// chunks and never returned to malloc individually, so destroy and reset cost
+// one free per chunk instead of one per node.
+WIDE_RADIX_EXPORT void wide_radix_init_with_flags(wide_radix_tree_t* tree, NvU32 key_bits, NvU32 flags);
 WIDE_RADIX_EXPORT bool wide_radix_insert(wide_radix_tree_t* tree, NvU64 key, NvU64 value);
 WIDE_RADIX_EXPORT bool wide_radix_delete(wide_radix_tree_t* tree, NvU64 key);
 WIDE_RADIX_EXPORT NvU64* wide_radix_lookup(wide_radix_tree_t* tree, NvU64 key);
 WIDE_RADIX_EXPORT NvU64* wide_radix_find_geq(wide_radix_tree_t* tree, NvU64 key);
+// Like wide_radix_find_geq, also storing the key that was found in *found_key (if given)
+WIDE_RADIX_EXPORT NvU64* wide_radix_find_geq_key(wide_radix_tree_t* tree, NvU64 key, NvU64* found_key);
 WIDE_RADIX_EXPORT bool wide_radix_empty(wide_radix_tree_t* tree);
 WIDE_RADIX_EXPORT void wide_radix_destroy(wide_radix_tree_t* tree);
+// Remove all keys, keeping key_bits and flags. An arena tree keeps its chunks
+// and carves them again from the start.
+WIDE_RADIX_EXPORT void wide_radix_reset(wide_radix_tree_t* tree);
+// Returns the bytes held by the tree and, if num_nodes is given, the number of live nodes.
+// Pointers returned by lookup/find_geq are valid until the next insert or delete.
+WIDE_RADIX_EXPORT size_t wide_radix_memory_usage(wide_radix_tree_t* tree, size_t* num_nodes);
 
 // Utility functions for bit manipulation
 static inline bool mask_get_bit(const wide_radix_mask_t* mask, int bit) {
@@ -53,6 +107,37 @@ static inline void mask_clear_bit(wide_radix_mask_t* mask, int bit) {
     mask->bits[bit / 64] &= ~(1ULL << (bit % 64));
 }
 
+// Number of set bits below bit, i.e. the dense slot of child bit
+static inline int mask_rank(const wide_radix_mask_t* mask, int bit) {
+    int word = bit / 64;
+    int rank = __builtin_popcountll(mask->bits[word] & ((1ULL << (bit % 64)) - 1));
+    for (int i = 0; i < word; i++) {
+        rank += __builtin_popcountll(mask->bits[i]);
+    }
+    return rank;
+}
+
+// First set bit at or after bit from, or 256 if there is none
+static inline int mask_next_bit(const wide_radix_mask_t* mask, int from) {
+    if (from >= 256) {
+        return 256;
+    }
+    int word = from / 64;
+    uint64_t bits = mask->bits[word] & (~0ULL << (from % 64));
+    while (!bits) {
+        if (++word == 4) {
+            return 256;
+        }
+        bits = mask->bits[word];
+    }
+    return word * 64 + __builtin_ctzll(bits);
+}
+
+static inline int mask_count(const wide_radix_mask_t* mask) {
+    return __builtin_popcountll(mask->bits[0]) + __builtin_popcountll(mask->bits[1]) +
+           __builtin_popcountll(mask->bits[2]) + __builtin_popcountll(mask->bits[3]);
+}
+
 #ifdef __cplusplus
 }
 #endif